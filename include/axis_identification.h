@@ -0,0 +1,73 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_AXIS_IDENTIFICATION_H
+#define DUAL_ALGEBRA_KINEMATICS_AXIS_IDENTIFICATION_H
+
+#include <limits>
+#include <vector>
+
+#include "unit_line.h"
+#include "dual_frame.h"
+
+/**
+ * \brief Identify the axis of a single moving joint from measured poses
+ *
+ * While only one revolute or cylindrical joint moves, every measured pose of a following link
+ *   is the reference pose moved around the fixed joint axis: pose = exp(axis, angle) * reference.
+ * Thus the constructive line of each relative motion pose * reference^-1 is a measurement of the axis.
+ * These lines are collected in a single pass over the poses and averaged by average_lines.
+ *
+ * Motions by small angles have badly conditioned axes, as the error of the axis grows with 1 / angle.
+ * They are weighted by 1 - cos(angle) and skipped below a minimum angle.
+ * Optionally, the average is repeated with Cauchy weights on the pluecker residuals to suppress outliers.
+ */
+class AxisIdentifier {
+private:
+    DualFrame reference; //!< The pose the relative motions start from
+    double minimum_angle; //!< Smallest accepted rotation angle of a relative motion
+    std::vector<double> lines; //!< Measured axes, six values per line
+    std::vector<double> weights; //!< Weight of each measured axis
+
+public:
+    /**
+     * \brief Start an identification
+     * @param reference The pose at the start of the motion, e.g. the first measured pose
+     * @param minimum_angle Relative motions with smaller rotations are skipped
+     */
+    explicit AxisIdentifier(const DualFrame &reference, double minimum_angle = 1e-2) noexcept;
+
+    /**
+     * \brief Add a measured pose
+     * @param pose The measured pose
+     * @return False if the pose was skipped as it is too close to the reference
+     */
+    bool add(const DualFrame &pose);
+
+    /**
+     * \brief Add many measured poses
+     * @param poses The measured poses
+     * @return The number of used poses
+     */
+    std::size_t add(const std::vector<DualFrame> &poses);
+
+    /**
+     * \brief Number of used poses
+     * @return The number of measured axes
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * \brief The identified joint axis
+     *
+     * The axis is oriented as the majority of the measured axes, i.e. positive angles for most of the poses.
+     * \exception std::domain_error If no pose was used
+     * @param scale The residual at which a measured axis has half weight, infinity for the plain average
+     * @param iterations Maximal number of reweighting steps
+     * @return The joint axis
+     */
+    UnitLine fit(double scale = std::numeric_limits<double>::infinity(), std::size_t iterations = 10) const;
+};
+
+#endif //DUAL_ALGEBRA_KINEMATICS_AXIS_IDENTIFICATION_H
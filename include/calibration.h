@@ -0,0 +1,65 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_CALIBRATION_H
+#define DUAL_ALGEBRA_KINEMATICS_CALIBRATION_H
+
+#include <vector>
+
+#include "ccc.h"
+
+/**
+ * \brief A measurement for the calibration
+ */
+struct CalibrationSample {
+    Configuration configuration; //!< Measured joint values
+    DualFrame pose; //!< Measured endeffector pose
+};
+
+/**
+ * \brief Result of a calibration
+ */
+struct CalibrationResult {
+    CCCMechanism mechanism; //!< The calibrated mechanism
+    double error; //!< Root mean square of the pose residuals of the calibrated mechanism
+    std::size_t iterations; //!< Number of performed iterations
+    /**
+     * \brief How the iteration ended
+     *
+     * CONVERGED if the error does not decrease noticeably anymore or the step vanishes,
+     *   MAX_ITERATIONS if the iteration limit is reached
+     *   and STALLED if no step decreases the error even with the largest damping.
+     */
+    RefinementState state;
+};
+
+/**
+ * \brief Identify the lines and the zero posture of a CCC mechanism from measurements
+ *
+ * The pose residual of each sample is the twist of the logarithm of the measured pose times the inverse computed pose,
+ *   computed by DualFrame::constructive_line.
+ * Its sum of squares is minimized by Levenberg-Marquardt.
+ *
+ * Each line has four parameters: rotations around two axes orthogonal to the line through its canonical anchor
+ *   and translations along these axes. The zero posture has six parameters of a twist applied from the left.
+ * The parameters are local: after each step the lines and the zero posture are moved and the parameters are zero again.
+ * Joint offsets need no parameters, as they are absorbed by the following lines and the zero posture.
+ *
+ * The Jacobian of the pose with respect to the parameters is analytic.
+ * Moving the line of joint i by a twist e changes the pose by the twist Ad(P_i) e - Ad(P_i M_i) e,
+ *   where P_i is the product of the joint motions before and M_i the motion of joint i.
+ * Moving the zero posture by a twist e changes the pose by Ad(M_1 M_2 M_3) e.
+ * The normal equations are accumulated over disjoint parts of the samples on several threads.
+ *
+ * \exception std::invalid_argument If there are less than three samples
+ * @param initial The nominal mechanism to start from
+ * @param samples The measurements
+ * @param iterations Maximal number of iterations
+ * @param threads The number of threads accumulating the normal equations
+ * @return The calibrated mechanism
+ */
+CalibrationResult calibrate(const CCCMechanism &initial, const std::vector<CalibrationSample> &samples,
+                            std::size_t iterations = 50, unsigned int threads = 1);
+
+#endif //DUAL_ALGEBRA_KINEMATICS_CALIBRATION_H
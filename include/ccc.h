@@ -6,11 +6,15 @@
 #define DAK_ADJOINT_TRIGONOMETRY_H
 
 #include <vector>
+#include <array>
 #include <tuple>
+#include <iterator>
+#include <new>
 
 #include "dual_number.h"
 #include "unit_line.h"
 #include "dual_frame.h"
+#include "subproblems.h"
 
 /**
  * \brief The configuration of an CCC mechanism
@@ -23,6 +27,217 @@ struct Configuration {
     DualNumberAlgebra::DualNumber phi_3; //!< Value of the third joint
 };
 
+/**
+ * \brief A configuration together with the error of the pose it yields to
+ *
+ * The residual is given as a dual number.
+ * The real part is the rotation angle between the reached and the requested orientation.
+ * The dual part is the distance between the reached and the requested position.
+ */
+struct VerifiedConfiguration {
+    Configuration configuration; //!< The solution of the inverse kinematics
+    DualNumberAlgebra::DualNumber residual; //!< Rotation angle error and translation error
+};
+
+/**
+ * \brief State of a numerical refinement of a configuration
+ */
+enum RefinementState {
+    CONVERGED, ///< The residual is below the tolerance
+    MAX_ITERATIONS, ///< The iteration limit is reached before the residual is below the tolerance
+    STALLED ///< A step did not decrease the residual anymore
+};
+
+/**
+ * \brief A configuration refined by Gauss-Newton steps
+ */
+struct RefinedConfiguration {
+    Configuration configuration; //!< The refined configuration
+    DualNumberAlgebra::DualNumber residual; //!< Rotation angle error and translation error of the refined configuration
+    RefinementState state; //!< Reason for the stop of the refinement
+    unsigned int iterations; //!< Number of performed Gauss-Newton steps
+};
+
+struct CCCMechanism;
+
+/**
+ * \brief Lazily evaluated solutions of the inverse kinematics of a CCC mechanism
+ *
+ * Only the second joint is solved on creation as it determines the number of solutions.
+ * The first and third joint are calculated not until the solution is actually requested.
+ * Thus, if only the first feasible solution is needed, the others are never computed.
+ *
+ * No container is allocated, the solutions of the second joint are kept in a fixed size buffer.
+ *
+ * The mechanism is referenced and thus has to outlive this object.
+ */
+class InverseSolutions {
+private:
+    /**
+     * \brief The solved mechanism
+     */
+    const CCCMechanism *mechanism;
+
+    /**
+     * \brief The requested pose
+     */
+    DualFrame pose;
+
+    /**
+     * \brief The requested pose without the zero posture
+     */
+    DualFrame s;
+
+    /**
+     * \brief Relation between the first line and the final third line
+     */
+    LineRelation parallelity;
+
+    /**
+     * \brief The solutions of the second joint
+     *
+     * The trigonometric equation yields up to two solutions and the parallel case adds one.
+     */
+    std::array<DualNumberAlgebra::DualNumber, 3> phi2_solutions;
+
+    /**
+     * \brief Number of valid entries in phi2_solutions
+     */
+    std::size_t count;
+
+public:
+    /**
+     * \brief Input iterator computing the configuration on dereferencing
+     */
+    class iterator {
+    private:
+        const InverseSolutions *solutions; //!< The iterated solutions
+        std::size_t index; //!< The current solution
+    public:
+        using iterator_category = std::input_iterator_tag; //!< Solutions can only be read
+        using value_type = Configuration; //!< The computed configuration
+        using difference_type = std::ptrdiff_t; //!< Distance between iterators
+        using pointer = const Configuration *; //!< Unused as configurations are computed
+        using reference = Configuration; //!< Configurations are returned by value
+
+        /**
+         * \brief Create the iterator for a solution
+         * @param solutions The iterated solutions
+         * @param index The index of the solution
+         */
+        iterator(const InverseSolutions *solutions, std::size_t index) noexcept;
+
+        /**
+         * \brief Compute the current configuration
+         * @return The configuration
+         */
+        Configuration operator*() const noexcept;
+
+        /**
+         * \brief Step to the next solution
+         * @return This iterator
+         */
+        iterator &operator++() noexcept;
+
+        /**
+         * \brief Step to the next solution
+         * @return The iterator before stepping
+         */
+        iterator operator++(int) noexcept;
+
+        /**
+         * \brief Comparison of iterators
+         * @param rhs right-hand-side
+         * @return True if equal
+         */
+        bool operator==(const iterator &rhs) const noexcept;
+
+        /**
+         * \brief Comparison of iterators
+         * @param rhs right-hand-side
+         * @return True if unequal
+         */
+        bool operator!=(const iterator &rhs) const noexcept;
+    };
+
+    /**
+     * \brief Solve the second joint for the pose
+     *
+     * \exception std::domain_error If no solution is possible
+     * @param mechanism The mechanism to solve
+     * @param pose The frame to reach
+     */
+    InverseSolutions(const CCCMechanism &mechanism, const DualFrame &pose);
+
+    /**
+     * \brief Solve the second joint for the pose without an exception
+     *
+     * If no solution is possible, the solutions are empty.
+     * Nothing is allocated, thus this is usable in real-time contexts.
+     * @param mechanism The mechanism to solve
+     * @param pose The frame to reach
+     */
+    InverseSolutions(const CCCMechanism &mechanism, const DualFrame &pose, std::nothrow_t) noexcept;
+
+    /**
+     * \brief Compute a single solution
+     * @param index Index of the solution, has to be less than size()
+     * @return The configuration of the solution
+     */
+    Configuration operator[](std::size_t index) const noexcept;
+
+    /**
+     * \brief The solution of the second joint without computing the first and the third joint
+     * @param index Index of the solution, has to be less than size()
+     * @return The value of the second joint
+     */
+    DualNumberAlgebra::DualNumber second_joint(std::size_t index) const noexcept;
+
+    /**
+     * \brief Compute a single solution with the residual of its pose
+     * \see InverseSolutions::verify
+     * @param index Index of the solution, has to be less than size()
+     * @return The configuration of the solution and its residual
+     */
+    VerifiedConfiguration verified(std::size_t index) const;
+
+    /**
+     * \brief Compute the residual of the pose a configuration yields to
+     *
+     * The solver keeps no intermediate quantity that bounds the error of the whole pose.
+     * Thus this is still a second forward kinematics, but composed of closed-form joint motions as 3x3 rotations
+     *   and translations and compared with the already reformulated pose.
+     * It only saves the embedded 6x6 matrices of CCCMechanism::forward.
+     * @param config The configuration to check
+     * @return The configuration and its residual
+     */
+    VerifiedConfiguration verify(const Configuration &config) const;
+
+    /**
+     * \brief The number of solutions
+     * @return The number of solutions
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * \brief Check if there is no solution
+     * @return True if there is no solution
+     */
+    bool empty() const noexcept;
+
+    /**
+     * \brief Iterator to the first solution
+     * @return Iterator
+     */
+    iterator begin() const noexcept;
+
+    /**
+     * \brief Iterator after the last solution
+     * @return Iterator
+     */
+    iterator end() const noexcept;
+};
+
 /**
  * \brief A CCC mechanism defined by three lines and a zero posture frame pointing the endeffector with zero valued joints
  *
@@ -31,7 +246,7 @@ struct CCCMechanism {
     UnitLine l12; //!< Line for the first C joint
     UnitLine l23; //!< Line for the second C joint
     UnitLine l34; //!< Line for the third C joint
-    DualFrame zero_posture; //!< Zero posture frame in 6x6 matrix representation
+    DualFrame zero_posture; //!< Endeffector pose in zeroed joint values
 
     /**
      * \brief Simple constructor for the CCC mechanism
@@ -49,6 +264,15 @@ struct CCCMechanism {
      */
     DualFrame forward(const Configuration &config) const noexcept;
 
+    /**
+     * \brief Forward kinematics with PoE into user memory
+     *
+     * The endeffector pose is written as row major homogeneous matrix.
+     * @param config The joint configuration to calculate the endeffector pose
+     * @param pose Pointer to storage for 16 doubles
+     */
+    void forward(const Configuration &config, double *pose) const noexcept;
+
     /**
      * \brief Verbose Forward kinematics with PoE
      *
@@ -69,6 +293,150 @@ struct CCCMechanism {
      * @return A list with possible configurations
      */
     std::vector<Configuration> inverse(const DualFrame &pose) const;
+
+    /**
+     * \brief The inverse kinematics for an Eigen isometry
+     *
+     * The linear part of the isometry is not checked to be a rotation.
+     * \see CCCMechanism::inverse(const DualFrame &) const
+     * \exception std::logic_error If no solution is possible
+     * @param pose The pose to reach
+     * @return A list with possible configurations
+     */
+    std::vector<Configuration> inverse(const Eigen::Isometry3d &pose) const;
+
+    /**
+     * \brief The inverse kinematics for a homogeneous matrix in user memory
+     *
+     * The memory is interpreted as row major 4x4 matrix and the rotation is not checked.
+     * \see CCCMechanism::inverse(const DualFrame &) const
+     * \exception std::logic_error If no solution is possible
+     * @param pose Pointer to 16 doubles
+     * @return A list with possible configurations
+     */
+    std::vector<Configuration> inverse(const double *pose) const;
+
+    /**
+     * \brief The inverse kinematics of the mechanism with locked joints
+     *
+     * The mechanisms like RCC, CRC, CCR or RRR are CCC mechanisms where some values have a zero dual or real part.
+     * The locked parts are not solved at all:
+     * A revolute second joint only solves the real part of the trigonometric equation,
+     *   a prismatic one a linear equation for the translation.
+     * The first and the third joint are given by the locked variants of Subproblem::transform_onto.
+     * If the first and the final third line are parallel or coinciding, translations or also rotations can be
+     *   exchanged between the first and the third joint. They are assigned to the joint which is not locked for them.
+     *
+     * A noisy pose yields the closest locked configuration.
+     * Only if its pose differs by more than the tolerance, e.g. for poses outside of the reduced workspace,
+     *   it is discarded.
+     *
+     * \exception std::domain_error If the second joint has no solution
+     * @param pose The frame to reach
+     * @param types The types of the three joints
+     * @param tolerance Accepted rotation angle and translation error of a solution
+     * @return A list with possible configurations, where the locked parts are exactly zero
+     */
+    std::vector<Configuration> inverse(const DualFrame &pose, const std::array<JointType, 3> &types,
+                                       double tolerance = 1e-6) const;
+
+    /**
+     * \brief The inverse kinematics of the orientation only for three revolute joints
+     *
+     * All lines are moved through the origin, such that every dual part vanishes.
+     * Thus the dual trigonometric equations reduce to real ones like for a spherical wrist.
+     *
+     * \exception std::domain_error If no solution is possible
+     * @param orientation The orientation to reach
+     * @return A list with possible configurations which have zero dual parts
+     */
+    std::vector<Configuration> inverse_orientation(const RotationMatrix &orientation) const;
+
+    /**
+     * \brief The lazy inverse kinematics
+     *
+     * Each Configuration is computed when it is iterated.
+     * The branches are the same as in CCCMechanism::inverse but no container is allocated.
+     * \exception std::domain_error If no solution is possible
+     * @param pose The frame to reach
+     * @return The lazily evaluated solutions
+     */
+    InverseSolutions inverse_lazy(const DualFrame &pose) const;
+
+    /**
+     * \brief The lazy inverse kinematics without an exception
+     *
+     * Same as CCCMechanism::inverse_lazy but the solutions are empty if no solution is possible.
+     * @param pose The frame to reach
+     * @return The lazily evaluated solutions
+     */
+    InverseSolutions inverse_lazy(const DualFrame &pose, std::nothrow_t) const noexcept;
+
+    /**
+     * \brief The inverse kinematics into a fixed size buffer
+     *
+     * Neither allocates nor throws, thus this is usable in real-time contexts.
+     * @param pose The frame to reach
+     * @param solutions Buffer for the solutions
+     * @return The number of solutions written to the buffer, zero if no solution is possible
+     */
+    std::size_t inverse(const DualFrame &pose, std::array<Configuration, 3> &solutions) const noexcept;
+
+    /**
+     * \brief The inverse kinematics with a residual for each solution
+     *
+     * The same as CCCMechanism::inverse but each solution contains the error of the pose it yields to.
+     * This makes a separate verification with CCCMechanism::forward unnecessary.
+     * \exception std::domain_error If no solution is possible
+     * @param pose The frame to reach
+     * @return A list with possible configurations and their residuals
+     */
+    std::vector<VerifiedConfiguration> inverse_verified(const DualFrame &pose) const;
+
+    /**
+     * \brief The spatial jacobian
+     *
+     * The columns are ordered as real and dual part of the first, second and third joint value.
+     * A real part column is the current joint line, a dual part column is the pure translation along it.
+     * The rows are the infinitesimal rotation followed by the infinitesimal translation of the endeffector,
+     *   both expressed in the base frame like the pluecker coordinates of a line.
+     *
+     * @param config The joint configuration
+     * @return The 6x6 jacobian
+     */
+    Eigen::Matrix<double, 6, 6> jacobian(const Configuration &config) const;
+
+    /**
+     * \brief Refine a configuration to a pose by Gauss-Newton steps on the dual joint values
+     *
+     * The steps use the analytic CCCMechanism::jacobian.
+     * Singular directions get the minimal norm step, thus redundant joint values are kept.
+     *
+     * @param pose The frame to reach
+     * @param seed The initial configuration, e.g. an analytic solution or the previous configuration
+     * @param max_iterations Upper bound of Gauss-Newton steps
+     * @param tolerance Accepted rotation angle and translation error
+     * @return The refined configuration with its convergence state
+     */
+    RefinedConfiguration refine(const DualFrame &pose, const Configuration &seed,
+                                unsigned int max_iterations = 10, double tolerance = 1e-10) const;
+
+    /**
+     * \brief The inverse kinematics with a refinement stage
+     *
+     * Every analytic solution is refined by CCCMechanism::refine.
+     * Invalid parts (NaN) of an analytic solution are replaced by the seed beforehand.
+     * If no analytic solution is found, e.g. due to a discriminant slightly below zero near singularities,
+     *   the seed is refined instead and yields the only solution.
+     *
+     * @param pose The frame to reach
+     * @param seed Fallback configuration, usually the previous configuration
+     * @param max_iterations Upper bound of Gauss-Newton steps per solution
+     * @param tolerance Accepted rotation angle and translation error
+     * @return A list with refined configurations
+     */
+    std::vector<RefinedConfiguration> inverse_refined(const DualFrame &pose, const Configuration &seed,
+                                                      unsigned int max_iterations = 10, double tolerance = 1e-10) const;
 };
 
 #endif //DAK_ADJOINT_TRIGONOMETRY_H
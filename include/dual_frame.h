@@ -7,39 +7,102 @@
 
 #include "dual_embedded_matrix.h"
 #include "dual_skew_product.h"
+#include "matrix3.h"
 #include "vector.h"
 
+#include <cstddef>
+
 /**
- * \brief Frame representation as a dual embedded matrix
+ * \brief Frame representation corresponding to a dual embedded matrix
  *
  * The rotation matrix is the real part.
- * The skew translation with rotation is the dual part
+ * The skew translation with rotation is the dual part.
+ *
+ * Only the rotation and the translation are stored.
+ * The dual part is derived if it is needed, see DualFrame::pxR and DualFrame::embedded.
  */
-class DualFrame: public DualEmbeddedMatrix {
-protected:
-    /**
-     * \brief Protected constructor with raw Eigen type
-     *
-     * It is protected to enforce a high level user to use the other constructor.
-     * Especially important to avoid wrong rotation matrix format.
-     *
-     * @param mat Data in Eigen type
-     */
-    explicit DualFrame(const Mat6 &mat) noexcept;
+class DualFrame {
+private:
+    RotationMatrix rotation; //!< The rotation of the frame
+    PointVector translation; //!< The position of the frame
+
 public:
     /**
      * \brief Embed a rotation and a position to a dual frame
      *
      * @param real The real matrix representing the rotation
-     * @param dual The dual matrix representing a mix of rotation and translation
+     * @param dual The position of the frame
      */
     DualFrame(const RotationMatrix &real, const PointVector &dual) noexcept;
 
+    /**
+     * \brief Convert an Eigen isometry to a dual frame
+     *
+     * \exception std::domain_error If the linear part is not a rotation
+     * @param pose The isometry
+     */
+    explicit DualFrame(const Eigen::Isometry3d &pose);
+
+    /**
+     * \brief Convert an Eigen isometry to a dual frame without the check of the rotation
+     * @param pose The isometry with a proper rotation as linear part
+     */
+    DualFrame(const Eigen::Isometry3d &pose, Unchecked) noexcept;
+
+    /**
+     * \brief Create a dual frame from a quaternion and a translation
+     *
+     * The quaternion is normalized, so it always describes a rotation.
+     * @param rotation The orientation as quaternion
+     * @param translation The position
+     */
+    DualFrame(const Eigen::Quaterniond &rotation, const Eigen::Vector3d &translation) noexcept;
+
+    /**
+     * \brief Convert a homogeneous matrix to a dual frame
+     *
+     * The last row is ignored.
+     * \exception std::domain_error If the upper left block is not a rotation
+     * @param pose The homogeneous matrix
+     * @return The frame
+     */
+    static DualFrame FromHomogeneous(const Eigen::Matrix4d &pose);
+
+    /**
+     * \brief Convert a homogeneous matrix in user memory to a dual frame without the check of the rotation
+     *
+     * The memory is interpreted as row major 4x4 matrix, only the upper 3x4 block is read.
+     * @param pose Pointer to 16 doubles with a proper rotation in the upper left block
+     * @return The frame
+     */
+    static DualFrame FromHomogeneous(const double *pose, Unchecked) noexcept;
+
+    /**
+     * \brief Convert the frame to a homogeneous matrix
+     * @return The homogeneous matrix
+     */
+    Eigen::Matrix4d homogeneous() const noexcept;
+
+    /**
+     * \brief Write the frame as homogeneous matrix to user memory
+     *
+     * The matrix is written in row major order.
+     * @param pose Pointer to storage for 16 doubles
+     */
+    void homogeneous(double *pose) const noexcept;
+
+    /**
+     * \brief Convert the frame to an Eigen isometry
+     * @return The isometry
+     */
+    Eigen::Isometry3d isometry() const noexcept;
+
     /**
      * \brief Map a DualSkewProduct to a frame
      *
      * This performs a generalized Rodriguez-Formula.
      * It corresponds to a map from a lie-algebra to a lie-group, allthough we are talking about se(3) and SE(3)
+     * The closed form is evaluated directly from the line and the dual angle without any matrix products.
      *
      * @param skew The skewproduct to map
      */
@@ -66,6 +129,8 @@ public:
      *
      * It is the inversion of the exponential map, thus the logarithm to calculate the lie algebra from the lie group.
      * So, the se(3) from the SE(3) is calculated.
+     * Half turns use the symmetric part of the rotation, a pure translation yields a line through the origin along the translation
+     * and the identity yields the z-axis with a zero angle.
      *
      * @return The transforming line with the angle yielding to this frame
      */
@@ -75,21 +140,71 @@ public:
      * \brief Retrieve the rotation matrix of the frame
      * @return The rotation matrix
      */
-    RotationMatrix R() const noexcept;
+    const RotationMatrix &R() const noexcept;
 
     /**
      * \brief Retrieve the skewed translation rotation product
+     *
+     * This is the dual part of the embedded matrix and calculated on each call
      * @return Return pxR
      */
     Matrix3 pxR() const noexcept;
 
     /**
      * \brief Retrieve the translation of the frame
-     *
-     * This is actually done by internally extracted it from pxR
      * @return The translation(position) of the frame
      */
-    PointVector p() const noexcept;
+    const PointVector &p() const noexcept;
+
+    /**
+     * \brief Build the dual embedded matrix of the frame
+     *
+     * The matrix is calculated on each call, so prefer DualFrame::R and DualFrame::p if possible.
+     * @return The embedded matrix with R as real part and pxR as dual part
+     */
+    DualEmbeddedMatrix embedded() const noexcept;
+
+    /**
+     * \brief Implicit conversion to the dual embedded matrix
+     *
+     * Keeps frames usable wherever an embedded matrix is expected, the matrix is built by DualFrame::embedded.
+     */
+    operator DualEmbeddedMatrix() const noexcept;
+
+    /**
+     * \brief Return the embedded matrix as Eigen type
+     *
+     * The matrix is built on each call, see DualFrame::embedded.
+     * @return The Eigen type of the embedded matrix
+     */
+    DualEmbeddedMatrix::Mat6 get() const noexcept;
+
+    /**
+     * \brief The negation of the embedded matrix
+     * @return The negated matrix, which is no frame anymore
+     */
+    DualEmbeddedMatrix operator-() const noexcept;
+
+    /**
+     * \brief The sum with an embedded matrix
+     * @param rhs The right-hand-side
+     * @return The sum, which is no frame anymore
+     */
+    DualEmbeddedMatrix operator+(const DualEmbeddedMatrix &rhs) const noexcept;
+
+    /**
+     * \brief The difference to an embedded matrix
+     * @param rhs The right-hand-side
+     * @return The difference, which is no frame anymore
+     */
+    DualEmbeddedMatrix operator-(const DualEmbeddedMatrix &rhs) const noexcept;
+
+    /**
+     * \brief The matrix product with an embedded matrix
+     * @param rhs The right-hand-side
+     * @return The product
+     */
+    DualEmbeddedMatrix operator*(const DualEmbeddedMatrix &rhs) const noexcept;
 
     /**
      * \brief Transformation of the UnitLine to a frame
@@ -103,6 +218,16 @@ public:
      */
     friend UnitLine operator*(const DualFrame &lhs, const UnitLine &rhs) noexcept;
 
+    /**
+     * \brief Transformation of a screw to a frame
+     *
+     * The same as Screw::Ad, so the embedded matrix is not built.
+     * @param lhs The frame
+     * @param rhs The screw to transform
+     * @return The screw transformed by the frame
+     */
+    friend Screw operator*(const DualFrame &lhs, const Screw &rhs) noexcept;
+
     /**
      * \brief Output formatting to homogenous matrices for a better readability
      * @param stream Output stream
@@ -120,4 +245,98 @@ public:
     friend bool operator==(const DualFrame &lhs, const DualFrame &rhs) noexcept;
 };
 
+/**
+ * \brief Contiguous storage of points or directions, one per column
+ */
+using PointBuffer = Eigen::Matrix<double, 3, Eigen::Dynamic>;
+
+/**
+ * \brief Transformation of many lines by a frame
+ *
+ * The lines are stored as direction and moment in the columns of the buffer.
+ * The buffer is transformed blockwise as matrix product, so there is no UnitLine constructed per line.
+ * The lines are not checked, thus they have to be normalized and orthogonal as for a UnitLine.
+ * The result may be the same buffer as the lines.
+ *
+ * @param frame The transforming frame
+ * @param lines The lines to transform
+ * @param result Storage for the transformed lines, has to have the same size as lines
+ * @param threads The number of threads working on disjoint parts of the buffer
+ */
+void transform_lines(const DualFrame &frame, const Eigen::Ref<const ScrewBuffer> &lines,
+                     Eigen::Ref<ScrewBuffer> result, unsigned int threads = 1);
+
+/**
+ * \brief Transformation of many lines in user memory
+ *
+ * The memory is interpreted as column major 6 x count matrix.
+ * \see transform_lines
+ *
+ * @param frame The transforming frame
+ * @param lines Pointer to 6 * count doubles
+ * @param result Pointer to 6 * count doubles, may be the same as lines
+ * @param count Number of lines
+ * @param threads The number of threads working on disjoint parts of the buffer
+ */
+void transform_lines(const DualFrame &frame, const double *lines, double *result, std::size_t count,
+                     unsigned int threads = 1);
+
+/**
+ * \brief Transformation of many points by a frame
+ *
+ * Every point x is mapped to R x + p.
+ * The result may be the same buffer as the points.
+ *
+ * @param frame The transforming frame
+ * @param points The points to transform
+ * @param result Storage for the transformed points, has to have the same size as points
+ * @param threads The number of threads working on disjoint parts of the buffer
+ */
+void transform_points(const DualFrame &frame, const Eigen::Ref<const PointBuffer> &points,
+                      Eigen::Ref<PointBuffer> result, unsigned int threads = 1);
+
+/**
+ * \brief Transformation of many points in user memory
+ *
+ * The memory is interpreted as column major 3 x count matrix.
+ * \see transform_points
+ *
+ * @param frame The transforming frame
+ * @param points Pointer to 3 * count doubles
+ * @param result Pointer to 3 * count doubles, may be the same as points
+ * @param count Number of points
+ * @param threads The number of threads working on disjoint parts of the buffer
+ */
+void transform_points(const DualFrame &frame, const double *points, double *result, std::size_t count,
+                      unsigned int threads = 1);
+
+/**
+ * \brief Rotation of many directions by a frame
+ *
+ * Every direction x is mapped to R x, the translation has no effect on directions.
+ * The result may be the same buffer as the directions.
+ *
+ * @param frame The transforming frame
+ * @param directions The directions to rotate
+ * @param result Storage for the rotated directions, has to have the same size as directions
+ * @param threads The number of threads working on disjoint parts of the buffer
+ */
+void transform_directions(const DualFrame &frame, const Eigen::Ref<const PointBuffer> &directions,
+                          Eigen::Ref<PointBuffer> result, unsigned int threads = 1);
+
+/**
+ * \brief Rotation of many directions in user memory
+ *
+ * The memory is interpreted as column major 3 x count matrix.
+ * \see transform_directions
+ *
+ * @param frame The transforming frame
+ * @param directions Pointer to 3 * count doubles
+ * @param result Pointer to 3 * count doubles, may be the same as directions
+ * @param count Number of directions
+ * @param threads The number of threads working on disjoint parts of the buffer
+ */
+void transform_directions(const DualFrame &frame, const double *directions, double *result, std::size_t count,
+                          unsigned int threads = 1);
+
 #endif //DUAL_ALGEBRA_KINEMATICS_DUAL_FRAME_H
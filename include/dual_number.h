@@ -15,6 +15,7 @@
 #include <stdexcept>
 #include <cmath>
 #include <vector>
+#include <array>
 
 /**
  * \brief Everything regarding the dual numbers
@@ -337,9 +338,25 @@ namespace DualNumberAlgebra {
      * @param cos_factor The factor before the cos term (a)
      * @param sin_factor The factor before the sin term (b)
      * @param offset The value of the sum (c)
+     * \exception std::domain_error If no solution is possible
      * @return A container with all found solutions for \f$\varphi\f$
      */
     std::vector<DualNumber> solve_trigonometric_equation(const DualNumber &cos_factor,const DualNumber &sin_factor, const DualNumber &offset);
+
+    /**
+     * \brief Solver for a dualized trigonometric equation without a heap allocated container
+     *
+     * Same as solve_trigonometric_equation(const DualNumber &, const DualNumber &, const DualNumber &)
+     *   but the solutions are written to a fixed size buffer.
+     * If no solution is possible, nothing is thrown but zero solutions are reported.
+     *
+     * @param cos_factor The factor before the cos term (a)
+     * @param sin_factor The factor before the sin term (b)
+     * @param offset The value of the sum (c)
+     * @param solutions Buffer for the found solutions for \f$\varphi\f$
+     * @return The number of found solutions (zero, one or two)
+     */
+    std::size_t solve_trigonometric_equation(const DualNumber &cos_factor,const DualNumber &sin_factor, const DualNumber &offset, std::array<DualNumber, 2> &solutions) noexcept;
 }
 
 #include <eigen3/Eigen/Eigen>
@@ -406,4 +423,33 @@ namespace Eigen {
     };
 }
 
+/**
+ * \brief Column-wise storage of many dual numbers with the real part in the first and the dual part in the second row
+ */
+using DualBuffer = Eigen::Matrix<double, 2, Eigen::Dynamic>;
+
+namespace DualNumberAlgebra {
+    /**
+     * \brief Solver for many independent dualized trigonometric equations
+     *
+     * Same as solve_trigonometric_equation(const DualNumber &, const DualNumber &, const DualNumber &, std::array<DualNumber, 2> &)
+     *   for each column, but without branches on blocks of equations
+     *   whose real and dual parts are split into separate arrays.
+     * If the discriminant is zero, both branches hold the single solution.
+     * Without a solution both branches are NaN.
+     *
+     * @param cos_factors The factors before the cos terms (a)
+     * @param sin_factors The factors before the sin terms (b)
+     * @param offsets The values of the sums (c)
+     * @param first Storage for the first solution branch, has to have as many columns as the factors
+     * @param second Storage for the second solution branch, has to have as many columns as the factors
+     * @param counts Storage for the number of found solutions (zero, one or two) of each equation
+     */
+    void solve_trigonometric_equations(const Eigen::Ref<const DualBuffer> &cos_factors,
+                                       const Eigen::Ref<const DualBuffer> &sin_factors,
+                                       const Eigen::Ref<const DualBuffer> &offsets,
+                                       Eigen::Ref<DualBuffer> first, Eigen::Ref<DualBuffer> second,
+                                       Eigen::Ref<Eigen::VectorXi> counts) noexcept;
+}
+
 #endif //DAK_DUAL_NUMBER_H
@@ -0,0 +1,99 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_FORWARD_CACHE_H
+#define DUAL_ALGEBRA_KINEMATICS_FORWARD_CACHE_H
+
+#include "ccc.h"
+
+/**
+ * \brief Forward kinematics of a CCC mechanism with cached partial products
+ *
+ * If only one joint changes, only the products after this joint are recomputed.
+ * The zero posture is folded into the last joint, such that
+ *
+ * \f$ M_1 M_2 M_3(l_{34}) Z = (M_1 M_2 Z) M_3(Z^{-1} l_{34}) \f$
+ *
+ * and a change of the third joint costs one frame of the Rodriguez formula and one product.
+ *
+ * The mechanism is referenced and thus has to outlive this object.
+ */
+class ForwardCache {
+private:
+    const CCCMechanism *mechanism; //!< The evaluated mechanism
+    UnitLine l34_local; //!< The third line in the zero posture frame
+    Configuration config; //!< The current configuration
+    DualFrame m1; //!< Transformation of the first joint
+    DualFrame m12; //!< Transformation of the first and second joint
+    DualFrame m12_zero; //!< Transformation of the first and second joint with the zero posture
+    DualFrame end; //!< The endeffector pose
+    UnitLine l23_moved; //!< The second line moved by the first joint
+    UnitLine l34_moved; //!< The third line moved by the first and second joint
+
+    /**
+     * \brief Recompute the products starting with a joint
+     * @param joint The first changed joint starting with 1
+     */
+    void recompute(unsigned int joint) noexcept;
+
+public:
+    /**
+     * \brief Evaluate the forward kinematics completely for the initial configuration
+     * @param mechanism The evaluated mechanism
+     * @param config The initial configuration
+     */
+    ForwardCache(const CCCMechanism &mechanism, const Configuration &config) noexcept;
+
+    /**
+     * \brief Change the first joint, everything is recomputed
+     * @param phi The new value of the joint
+     */
+    void set_phi_1(const DualNumberAlgebra::DualNumber &phi) noexcept;
+
+    /**
+     * \brief Change the second joint, the first joint is kept
+     * @param phi The new value of the joint
+     */
+    void set_phi_2(const DualNumberAlgebra::DualNumber &phi) noexcept;
+
+    /**
+     * \brief Change the third joint, only the last frame is recomputed
+     * @param phi The new value of the joint
+     */
+    void set_phi_3(const DualNumberAlgebra::DualNumber &phi) noexcept;
+
+    /**
+     * \brief Change the configuration
+     *
+     * The recomputation starts at the first joint whose value differs.
+     * @param config The new configuration
+     */
+    void update(const Configuration &config) noexcept;
+
+    /**
+     * \brief The current configuration
+     * @return The configuration
+     */
+    const Configuration &configuration() const noexcept;
+
+    /**
+     * \brief The endeffector pose of the current configuration
+     * @return The pose as CCCMechanism::forward
+     */
+    const DualFrame &pose() const noexcept;
+
+    /**
+     * \brief The second line moved by the first joint
+     * @return The line as in CCCMechanism::forward_verbose
+     */
+    const UnitLine &second_line() const noexcept;
+
+    /**
+     * \brief The third line moved by the first and second joint
+     * @return The line as in CCCMechanism::forward_verbose
+     */
+    const UnitLine &third_line() const noexcept;
+};
+
+#endif //DUAL_ALGEBRA_KINEMATICS_FORWARD_CACHE_H
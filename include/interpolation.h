@@ -0,0 +1,80 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_INTERPOLATION_H
+#define DUAL_ALGEBRA_KINEMATICS_INTERPOLATION_H
+
+#include <vector>
+
+#include "dual_frame.h"
+
+/**
+ * \brief Screw linear interpolation (ScLERP) between two frames
+ *
+ * The relative motion between the frames is a transformation around its constructive line.
+ * The interpolated frame is the start frame transformed around this line by the scaled dual angle.
+ *
+ * @param from The frame for t = 0
+ * @param to The frame for t = 1
+ * @param t The interpolation parameter
+ * @return The interpolated frame
+ */
+DualFrame sclerp(const DualFrame &from, const DualFrame &to, double t) noexcept;
+
+/**
+ * \brief Streaming screw linear interpolation with equidistant steps
+ *
+ * The constructive line of the relative motion is computed once.
+ * Each step is then a single concatenation with the constant step frame, independent of the segment.
+ * Multiple key frames are interpolated segment by segment.
+ */
+class ScrewInterpolator {
+private:
+    std::vector<DualFrame> keyframes; //!< The interpolated key frames
+    unsigned int steps; //!< Number of steps per segment
+    std::size_t segment; //!< The current segment starting at keyframes[segment]
+    unsigned int step; //!< The current step within the segment
+    DualFrame current; //!< The last generated frame
+    DualFrame increment; //!< The constant step frame of the current segment
+
+    /**
+     * \brief Compute the step frame of the current segment
+     */
+    void start_segment() noexcept;
+
+public:
+    /**
+     * \brief Interpolation between two frames
+     * \exception std::invalid_argument If the number of steps is zero
+     * @param from The start frame
+     * @param to The end frame
+     * @param steps Number of generated frames, the last one is the end frame
+     */
+    ScrewInterpolator(const DualFrame &from, const DualFrame &to, unsigned int steps);
+
+    /**
+     * \brief Interpolation between consecutive key frames
+     * \exception std::invalid_argument If the number of steps is zero or there are less than two key frames
+     * @param keyframes The key frames to pass through
+     * @param steps Number of generated frames per segment, the last one is the key frame ending the segment
+     */
+    ScrewInterpolator(const std::vector<DualFrame> &keyframes, unsigned int steps);
+
+    /**
+     * \brief Check if there are frames left
+     * @return True if ScrewInterpolator::next can be called
+     */
+    bool has_next() const noexcept;
+
+    /**
+     * \brief Generate the next frame
+     *
+     * The key frames itself are returned exactly, thus the error does not accumulate over the segments.
+     * Must only be called if ScrewInterpolator::has_next is true.
+     * @return The next interpolated frame
+     */
+    DualFrame next() noexcept;
+};
+
+#endif //DUAL_ALGEBRA_KINEMATICS_INTERPOLATION_H
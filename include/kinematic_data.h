@@ -0,0 +1,118 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_KINEMATIC_DATA_H
+#define DUAL_ALGEBRA_KINEMATICS_KINEMATIC_DATA_H
+
+#include <cstddef>
+#include <type_traits>
+
+#include "ccc.h"
+
+/**
+ * \brief Plain storage of a line as direction and moment
+ *
+ * In contrast to UnitLine it is trivially copyable and has no alignment requirements,
+ *   so it can be stored in bulk, copied with memcpy or mapped from a file.
+ * Nothing is checked, thus the content is only a line if the direction is normalized and orthogonal to the moment.
+ */
+struct LineData {
+    double n[3]; //!< The direction
+    double m[3]; //!< The moment
+};
+
+/**
+ * \brief Plain storage of a frame as rotation and position
+ *
+ * \see LineData
+ */
+struct FrameData {
+    double R[9]; //!< The rotation matrix in column major order
+    double p[3]; //!< The position
+};
+
+/**
+ * \brief Plain storage of the configuration of a CCC mechanism
+ *
+ * \see LineData
+ */
+struct ConfigData {
+    double angle[3]; //!< The real parts of the joint values
+    double distance[3]; //!< The dual parts of the joint values
+};
+
+static_assert(std::is_trivially_copyable<LineData>::value && std::is_standard_layout<LineData>::value,
+        "LineData has to be a plain type");
+static_assert(std::is_trivially_copyable<FrameData>::value && std::is_standard_layout<FrameData>::value,
+        "FrameData has to be a plain type");
+static_assert(std::is_trivially_copyable<ConfigData>::value && std::is_standard_layout<ConfigData>::value,
+        "ConfigData has to be a plain type");
+static_assert(sizeof(LineData) == 6 * sizeof(double), "LineData must not be padded");
+
+/**
+ * \brief Store a line
+ * @param line The line
+ * @return The plain data of the line
+ */
+LineData to_data(const UnitLine &line) noexcept;
+
+/**
+ * \brief Store a frame
+ * @param frame The frame
+ * @return The plain data of the frame
+ */
+FrameData to_data(const DualFrame &frame) noexcept;
+
+/**
+ * \brief Store a configuration
+ * @param configuration The configuration
+ * @return The plain data of the configuration
+ */
+ConfigData to_data(const Configuration &configuration) noexcept;
+
+/**
+ * \brief Restore a line without any check
+ *
+ * The data has to come from a line, e.g. by to_data.
+ * @param data The plain data
+ * @return The line
+ */
+UnitLine to_line(const LineData &data) noexcept;
+
+/**
+ * \brief Restore a frame without any check
+ *
+ * The data has to come from a frame, e.g. by to_data.
+ * @param data The plain data
+ * @return The frame
+ */
+DualFrame to_frame(const FrameData &data) noexcept;
+
+/**
+ * \brief Restore a configuration
+ * @param data The plain data
+ * @return The configuration
+ */
+Configuration to_configuration(const ConfigData &data) noexcept;
+
+/**
+ * \brief View many stored lines as line buffer
+ *
+ * The view can be passed to the batch functions, e.g. transform_lines, without a copy.
+ * @param data Pointer to the first line
+ * @param count Number of lines
+ * @return Writable view with one line per column
+ */
+Eigen::Map<ScrewBuffer> view(LineData *data, std::size_t count) noexcept;
+
+/**
+ * \brief View many stored lines as constant line buffer
+ * \see view(LineData *, std::size_t)
+ * @param data Pointer to the first line
+ * @param count Number of lines
+ * @return Constant view with one line per column
+ */
+Eigen::Map<const ScrewBuffer> view(const LineData *data, std::size_t count) noexcept;
+
+#endif //DUAL_ALGEBRA_KINEMATICS_KINEMATIC_DATA_H
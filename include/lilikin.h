@@ -10,16 +10,30 @@
 
 #include <lilikin/screw.h>
 #include <lilikin/unit_line.h>
+#include <lilikin/subproblems.h>
+#include <lilikin/ray_casting.h>
+#include <lilikin/line_segment.h>
+#include <lilikin/line_index.h>
+#include <lilikin/line_table.h>
+#include <lilikin/line_fitting.h>
+#include <lilikin/line_registration.h>
+#include <lilikin/axis_identification.h>
 
 #include <lilikin/dual_number.h>
 #include <lilikin/dual_embedded_matrix.h>
 #include <lilikin/dual_skew.h>
 #include <lilikin/dual_skew_product.h>
 #include <lilikin/dual_frame.h>
+#include <lilikin/interpolation.h>
 
+#include <lilikin/kinematic_data.h>
 #include <lilikin/random.h>
 #include <lilikin/precision.h>
 
 #include <lilikin/ccc.h>
+#include <lilikin/forward_cache.h>
+#include <lilikin/calibration.h>
+#include <lilikin/line_chain.h>
+#include <lilikin/structured_mechanism.h>
 
 #endif //LIBRARY_FOR_LINE_KINEMATICS_LILIKIN_H
@@ -0,0 +1,142 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_LINE_CHAIN_H
+#define DUAL_ALGEBRA_KINEMATICS_LINE_CHAIN_H
+
+#include <array>
+#include <utility>
+
+#include "dual_number.h"
+#include "unit_line.h"
+#include "dual_frame.h"
+#include "dual_skew_product.h"
+#include "matrix3.h"
+#include "vector.h"
+
+/**
+ * \brief A serial chain of N C joints defined by lines and a zero posture frame
+ *
+ * This generalizes the CCCMechanism to an arbitrary number of joints.
+ * The joint count is a template parameter such that every loop over the joints is unrolled at compile-time.
+ * Revolute and prismatic joints are C joints where the dual or the real part of the value is kept zero.
+ *
+ * @tparam N Number of joints
+ */
+template<std::size_t N>
+struct LineChain {
+    static_assert(N > 0, "A chain needs at least one joint");
+
+    /**
+     * \brief The joint values in the order of the lines
+     */
+    using Values = std::array<DualNumberAlgebra::DualNumber, N>;
+
+    /**
+     * \brief The jacobian with a real and a dual column per joint
+     */
+    using Jacobian = Eigen::Matrix<double, 6, 2 * N>;
+
+    std::array<UnitLine, N> lines; //!< Lines of the joints in the zero posture
+    DualFrame zero_posture; //!< Zero posture frame, stored as rotation and translation
+
+    /**
+     * \brief Simple constructor for the chain
+     * @param lines The joint lines ordered from the base to the endeffector
+     * @param zero_posture Endeffector pose in zeroed joint values
+     */
+    LineChain(const std::array<UnitLine, N> &lines, const DualFrame &zero_posture) noexcept
+        : lines(lines), zero_posture(zero_posture) {}
+
+    /**
+     * \brief Forward kinematics with PoE
+     * @param values The joint values to calculate the endeffector pose
+     * @return The endeffector pose
+     */
+    DualFrame forward(const Values &values) const noexcept {
+        return this->product(values, std::make_index_sequence<N>{}) * this->zero_posture;
+    }
+
+    /**
+     * \brief Verbose Forward kinematics with PoE
+     *
+     * This one also returns the line positions yielding from the transformations of the lines before.
+     * Contrary to CCCMechanism::forward_verbose the first line is contained as well,
+     *   such that the i-th line is the current position of the i-th joint.
+     *
+     * @param values The joint values to calculate the endeffector pose
+     * @return A pair containing the endeffector pose and the current lines
+     */
+    std::pair<DualFrame, std::array<UnitLine, N>> forward_verbose(const Values &values) const {
+        return this->verbose<1>(values, this->joint<0>(values), this->lines[0]);
+    }
+
+    /**
+     * \brief The spatial jacobian
+     *
+     * The columns are ordered as real and dual part of each joint value.
+     * See CCCMechanism::jacobian for the layout of the rows.
+     *
+     * @param values The joint values
+     * @return The 6x2N jacobian
+     */
+    Jacobian jacobian(const Values &values) const {
+        return this->columns(this->forward_verbose(values).second, std::make_index_sequence<N>{});
+    }
+
+private:
+    /**
+     * \brief Transformation of a single joint by the generalized rodriguez formula
+     */
+    template<std::size_t I>
+    DualFrame joint(const Values &values) const noexcept {
+        return DualFrame(DualSkewProduct(this->lines[I], values[I]));
+    }
+
+    /**
+     * \brief Product of all joint transformations as fold expression
+     */
+    template<std::size_t ...I>
+    DualFrame product(const Values &values, std::index_sequence<I...>) const noexcept {
+        return (this->joint<I>(values) * ...);
+    }
+
+    /**
+     * \brief Recursion over the joints accumulating the product and the transformed lines
+     */
+    template<std::size_t I, typename ...Lines>
+    std::pair<DualFrame, std::array<UnitLine, N>>
+    verbose(const Values &values, const DualFrame &prefix, const Lines &...transformed) const {
+        if constexpr (I == N) {
+            return std::make_pair(prefix * this->zero_posture, std::array<UnitLine, N>{transformed...});
+        } else {
+            return this->verbose<I + 1>(values, prefix * this->joint<I>(values), transformed..., prefix * this->lines[I]);
+        }
+    }
+
+    /**
+     * \brief Fill the jacobian columns of all joints
+     */
+    template<std::size_t ...I>
+    static Jacobian columns(const std::array<UnitLine, N> &current, std::index_sequence<I...>) {
+        Jacobian jacobian;
+        (column<I>(jacobian, current[I]), ...);
+        return jacobian;
+    }
+
+    /**
+     * \brief Fill the rotational and translational column of a single joint
+     */
+    template<std::size_t I>
+    static void column(Jacobian &jacobian, const UnitLine &line) {
+        // Rotation around the line
+        jacobian.template block<3, 1>(0, 2 * I) = line.n(unchecked).get();
+        jacobian.template block<3, 1>(3, 2 * I) = line.m().get();
+        // Translation along the line
+        jacobian.template block<3, 1>(0, 2 * I + 1) = Eigen::Matrix<double, 3, 1>::Zero();
+        jacobian.template block<3, 1>(3, 2 * I + 1) = line.n(unchecked).get();
+    }
+};
+
+#endif //DUAL_ALGEBRA_KINEMATICS_LINE_CHAIN_H
@@ -0,0 +1,146 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_LINE_FITTING_H
+#define DUAL_ALGEBRA_KINEMATICS_LINE_FITTING_H
+
+#include <vector>
+
+#include "unit_line.h"
+#include "dual_frame.h"
+
+/**
+ * \brief Streaming least squares fit of a line to points
+ *
+ * Only the number of points, their mean and their scatter matrix are accumulated,
+ *   so the points are visited once and never stored.
+ * Fitters of disjoint point sets can be merged, e.g. after accumulating on several threads.
+ * The fitted line runs through the mean along the principal eigenvector of the scatter,
+ *   which minimizes the sum of the squared distances of the points to the line.
+ */
+class LineFitter {
+private:
+    std::size_t count; //!< Number of accumulated points
+    Eigen::Vector3d mean; //!< Mean of the accumulated points
+    Eigen::Matrix3d scatter; //!< Sum of the outer products of the centered points
+
+    /**
+     * \brief Add the statistics of another point set
+     * @param other_count Number of points of the other set
+     * @param other_mean Mean of the other set
+     * @param other_scatter Scatter of the other set
+     */
+    void merge(std::size_t other_count, const Eigen::Vector3d &other_mean, const Eigen::Matrix3d &other_scatter) noexcept;
+
+public:
+    /**
+     * \brief Create a fitter without any points
+     */
+    LineFitter() noexcept;
+
+    /**
+     * \brief Add a single point
+     * @param point The point
+     */
+    void add(const PointVector &point) noexcept;
+
+    /**
+     * \brief Add many points
+     * @param points The points, one per column
+     * @param threads The number of threads accumulating disjoint parts of the points
+     */
+    void add(const Eigen::Ref<const PointBuffer> &points, unsigned int threads = 1);
+
+    /**
+     * \brief Add all points of another fitter
+     * @param other The other fitter
+     */
+    void merge(const LineFitter &other) noexcept;
+
+    /**
+     * \brief Number of accumulated points
+     * @return The number of points
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * \brief The mean of the accumulated points
+     * \exception std::domain_error If no point was added
+     * @return The mean
+     */
+    PointVector centroid() const;
+
+    /**
+     * \brief The least squares line
+     *
+     * The points are considered equal if the sum of their squared distances along the direction of the largest spread
+     *   does not exceed the squared precision of Compare times the number of points.
+     * \exception std::domain_error If all accumulated points are equal
+     * @return The line through the mean along the direction of the largest spread
+     */
+    UnitLine fit() const;
+
+    /**
+     * \brief The least squares line without an exception
+     *
+     * This is the same as LineFitter::fit but reports equal points by the return value.
+     * @param line Storage for the line, only written if there is one
+     * @return False if all accumulated points are equal and there is no line
+     */
+    bool fit(UnitLine &line) const noexcept;
+
+    /**
+     * \brief The remaining error of the fitted line
+     * @return The sum of the squared distances of the points to the fitted line
+     */
+    double residual() const noexcept;
+};
+
+/**
+ * \brief Weighted least squares average of lines in pluecker coordinates
+ *
+ * The direction is the principal eigenvector of the weighted sum of n n^T,
+ *   so lines of either orientation contribute alike. It is oriented as the majority of the weighted lines.
+ * The anchor is the point with the least weighted sum of squared distances to all lines,
+ *   the equations only use the canonical anchors n x m which do not depend on the orientation.
+ * Both sums are accumulated in a single pass over the lines.
+ *
+ * \exception std::domain_error If there is no line with a positive weight
+ * @param lines The lines with direction in the upper and moment in the lower three rows
+ * @param weights The non-negative weight of each line
+ * @return The average line
+ */
+UnitLine average_lines(const Eigen::Ref<const ScrewBuffer> &lines, const Eigen::Ref<const Eigen::VectorXd> &weights);
+
+/**
+ * \brief A line found in a point set
+ */
+struct ExtractedLine {
+    UnitLine line; //!< The least squares line of the inliers
+    std::vector<Eigen::Index> inliers; //!< Columns of the points belonging to the line
+};
+
+/**
+ * \brief Extract several lines from a point set by RANSAC
+ *
+ * Lines are searched one after another.
+ * Each search draws lines through two random remaining points and counts the points within the threshold,
+ *   where the distances of a block of points are computed at once like in UnitLine::get_distance(const PointVector &).
+ * The best candidate is refined by a least squares fit to its inliers, and the inliers are removed.
+ * The extraction stops if no candidate has enough inliers.
+ * A candidate whose inliers are equal within the precision, see LineFitter::fit, is skipped and its inliers are removed.
+ *
+ * @param points The points, one per column
+ * @param threshold Maximal distance of an inlier to its line
+ * @param minimum_inliers Minimal number of inliers of an extracted line, at least 2
+ * @param maximum_lines Maximal number of extracted lines
+ * @param iterations Number of random candidates per line
+ * @param seed Seed of the random sampling, fixed for reproducible results
+ * @return The extracted lines ordered by their search
+ */
+std::vector<ExtractedLine> extract_lines(const Eigen::Ref<const PointBuffer> &points, double threshold,
+                                         std::size_t minimum_inliers, std::size_t maximum_lines = 10,
+                                         std::size_t iterations = 500, unsigned int seed = 0);
+
+#endif //DUAL_ALGEBRA_KINEMATICS_LINE_FITTING_H
@@ -0,0 +1,161 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_LINE_INDEX_H
+#define DUAL_ALGEBRA_KINEMATICS_LINE_INDEX_H
+
+#include <vector>
+
+#include "line_segment.h"
+
+/**
+ * \brief A segment found by a query of the LineIndex
+ */
+struct LineNeighbor {
+    std::size_t index; //!< Index of the segment in the order of insertion
+    double distance; //!< Exact distance between the segment and the query
+};
+
+/**
+ * \brief Bounding volume hierarchy over line segments for proximity queries
+ *
+ * Every segment is a leaf with its axis aligned bounding box.
+ * The boxes only give lower bounds of the distances to prune the search,
+ *   the exact distances are computed by the segments with UnitLine::point_project and UnitLine::get_distance.
+ *
+ * A bulk build splits the segments at the median of the longest axis and yields a balanced tree.
+ * Incremental inserts place the new leaf next to the sibling which enlarges the boxes the least.
+ * Queries do not modify the index, so many of them can run in parallel.
+ */
+class LineIndex {
+private:
+    /**
+     * \brief A node of the hierarchy
+     */
+    struct Node {
+        Eigen::AlignedBox3d box; //!< Bounding box of all segments below
+        int parent; //!< Index of the parent node, -1 for the root
+        int left; //!< Index of the first child, -1 for a leaf
+        int right; //!< Index of the second child, -1 for a leaf
+        std::size_t segment; //!< Index of the segment of a leaf
+    };
+
+    std::vector<LineSegment> segments; //!< The indexed segments in order of insertion
+    std::vector<Node> nodes; //!< The nodes of the hierarchy
+    int root; //!< Index of the root node, -1 if empty
+
+    /**
+     * \brief Build a balanced subtree
+     * @param leaves The leaf nodes to combine, reordered during the build
+     * @param begin First leaf of the subtree
+     * @param end Behind the last leaf of the subtree
+     * @return Index of the root of the subtree
+     */
+    int build(std::vector<int> &leaves, std::size_t begin, std::size_t end);
+
+    /**
+     * \brief Create the leaf of a segment
+     * @param segment Index of the segment
+     * @return Index of the leaf node
+     */
+    int create_leaf(std::size_t segment);
+
+    /**
+     * \brief Generic k nearest search
+     */
+    template<typename Query>
+    std::vector<LineNeighbor> search_nearest(const Query &query, std::size_t k) const;
+
+    /**
+     * \brief Generic range search
+     */
+    template<typename Query>
+    std::vector<LineNeighbor> search_within(const Query &query, double distance) const;
+
+public:
+    /**
+     * \brief Create an empty index
+     */
+    LineIndex() noexcept;
+
+    /**
+     * \brief Bulk build of a balanced index
+     * @param segments The segments to index
+     */
+    explicit LineIndex(const std::vector<LineSegment> &segments);
+
+    /**
+     * \brief Add a segment to the index
+     * @param segment The segment
+     * @return The index of the segment used in the query results
+     */
+    std::size_t insert(const LineSegment &segment);
+
+    /**
+     * \brief Number of indexed segments
+     * @return The number of segments
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * \brief Access an indexed segment
+     * @param index Index of the segment
+     * @return The segment
+     */
+    const LineSegment &operator[](std::size_t index) const noexcept;
+
+    /**
+     * \brief Find the k segments closest to a point
+     * @param point The query point
+     * @param k Maximum number of results
+     * @return The closest segments sorted by distance
+     */
+    std::vector<LineNeighbor> nearest(const PointVector &point, std::size_t k) const;
+
+    /**
+     * \brief Find the k segments closest to a line
+     * @param line The query line
+     * @param k Maximum number of results
+     * @return The closest segments sorted by distance
+     */
+    std::vector<LineNeighbor> nearest(const UnitLine &line, std::size_t k) const;
+
+    /**
+     * \brief Find all segments within a distance to a point
+     * @param point The query point
+     * @param distance The maximal distance
+     * @return The found segments sorted by distance
+     */
+    std::vector<LineNeighbor> within(const PointVector &point, double distance) const;
+
+    /**
+     * \brief Find all segments within a distance to a line
+     * @param line The query line
+     * @param distance The maximal distance
+     * @return The found segments sorted by distance
+     */
+    std::vector<LineNeighbor> within(const UnitLine &line, double distance) const;
+
+    /**
+     * \brief Find the k segments closest to each of many points
+     * @param points The query points
+     * @param k Maximum number of results per query
+     * @param threads The number of threads working on disjoint parts of the queries
+     * @return The results in the order of the queries
+     */
+    std::vector<std::vector<LineNeighbor>> nearest(const std::vector<PointVector> &points, std::size_t k,
+                                                   unsigned int threads = 1) const;
+
+    /**
+     * \brief Find the k segments closest to each of many lines
+     * @param lines The query lines
+     * @param k Maximum number of results per query
+     * @param threads The number of threads working on disjoint parts of the queries
+     * @return The results in the order of the queries
+     */
+    std::vector<std::vector<LineNeighbor>> nearest(const std::vector<UnitLine> &lines, std::size_t k,
+                                                   unsigned int threads = 1) const;
+};
+
+#endif //DUAL_ALGEBRA_KINEMATICS_LINE_INDEX_H
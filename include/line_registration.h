@@ -0,0 +1,76 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_LINE_REGISTRATION_H
+#define DUAL_ALGEBRA_KINEMATICS_LINE_REGISTRATION_H
+
+#include <limits>
+#include <vector>
+
+#include "unit_line.h"
+#include "dual_frame.h"
+
+/**
+ * \brief Result of a line registration
+ */
+struct Registration {
+    DualFrame frame; //!< The frame mapping the first lines onto the second ones
+    double error; //!< Weighted root mean square of the pluecker coordinate residuals
+    bool valid; //!< False if the lines do not determine a frame, e.g. if all of them are parallel
+};
+
+/**
+ * \brief Find the frame aligning a set of lines with corresponding lines
+ *
+ * The frame T is fitted in two closed form steps:
+ *   First the rotation aligns the directions alone by the singular value decomposition of their correlation (Kabsch).
+ *   Then, with this rotation fixed, the translation p is the linear least squares solution of the moment equations
+ *   to.m = R from.m + p x R from.n, which only leaves the offsets orthogonal to the directions.
+ * For exact correspondences this is the exact frame. For noisy lines it is in general not the minimizer
+ *   of the combined squared differences of the pluecker coordinates, as the moments do not influence the rotation.
+ * Corresponding lines need the same orientation.
+ * At least two non parallel lines are needed.
+ *
+ * \exception std::invalid_argument If the number of lines differs
+ * \exception std::domain_error If all lines are parallel
+ * @param from The lines to transform
+ * @param to The target lines
+ * @return The aligning frame
+ */
+DualFrame register_lines(const std::vector<UnitLine> &from, const std::vector<UnitLine> &to);
+
+/**
+ * \brief Robust registration of lines stored as screws
+ *
+ * The same two-step fit as register_lines(const std::vector<UnitLine> &, const std::vector<UnitLine> &).
+ * With a finite scale it is iteratively reweighted,
+ *   each line pair is weighted by 1 / (1 + (r / scale)^2) of its residual r (Cauchy weights),
+ *   so a few wrong correspondences barely influence the result.
+ * The columns are expected to be lines. This is not checked.
+ *
+ * @param from The lines to transform, one per column
+ * @param to The target lines, one per column
+ * @param scale The residual at which a pair has half weight, infinity for the unweighted two-step solution
+ * @param iterations Maximal number of reweighting steps
+ * @return The registration, invalid if the number of lines differs or the lines are parallel
+ */
+Registration register_lines(const Eigen::Ref<const ScrewBuffer> &from, const Eigen::Ref<const ScrewBuffer> &to,
+                            double scale = std::numeric_limits<double>::infinity(),
+                            std::size_t iterations = 10) noexcept;
+
+/**
+ * \brief Many independent robust registrations
+ *
+ * @param from The lines to transform of each registration
+ * @param to The target lines of each registration
+ * @param scale The residual at which a pair has half weight, infinity for the unweighted two-step solution
+ * @param iterations Maximal number of reweighting steps
+ * @param threads The number of threads working on disjoint registrations
+ * @return The registrations in the given order
+ */
+std::vector<Registration> register_lines(const std::vector<ScrewBuffer> &from, const std::vector<ScrewBuffer> &to,
+                                         double scale = std::numeric_limits<double>::infinity(),
+                                         std::size_t iterations = 10, unsigned int threads = 1);
+
+#endif //DUAL_ALGEBRA_KINEMATICS_LINE_REGISTRATION_H
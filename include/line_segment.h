@@ -0,0 +1,208 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_LINE_SEGMENT_H
+#define DUAL_ALGEBRA_KINEMATICS_LINE_SEGMENT_H
+
+#include <limits>
+#include <utility>
+
+#include "unit_line.h"
+#include "vector.h"
+
+/**
+ * \brief Buffer of segments with the start point in the upper and the end point in the lower three rows
+ */
+using SegmentBuffer = Eigen::Matrix<double, 6, Eigen::Dynamic>;
+
+/**
+ * \brief A bounded part of a line
+ *
+ * The segment is given by its line and the signed distances of both end points
+ *   from the canonical anchor of the line along its direction.
+ */
+class LineSegment {
+private:
+    UnitLine carrier; //!< The line containing the segment
+    PointVector first; //!< Start point
+    PointVector second; //!< End point
+    double extent; //!< Distance between start and end point
+
+public:
+    /**
+     * \brief Create a segment between two points
+     * \exception std::invalid_argument If the points are equal
+     * @param start Start point
+     * @param end End point
+     */
+    LineSegment(const PointVector &start, const PointVector &end);
+
+    /**
+     * \brief Cut a segment from a line
+     * \exception std::invalid_argument If the segment would be empty or inverted
+     * @param line The line containing the segment
+     * @param from Distance of the start point from the canonical anchor along the direction
+     * @param to Distance of the end point from the canonical anchor along the direction, greater than from
+     */
+    LineSegment(const UnitLine &line, double from, double to);
+
+    /**
+     * \brief The line containing the segment
+     * @return The line directed from start to end
+     */
+    const UnitLine &line() const noexcept;
+
+    /**
+     * \brief The start point
+     * @return The start point
+     */
+    const PointVector &start() const noexcept;
+
+    /**
+     * \brief The end point
+     * @return The end point
+     */
+    const PointVector &end() const noexcept;
+
+    /**
+     * \brief The length of the segment
+     * @return The distance between start and end point
+     */
+    double length() const noexcept;
+
+    /**
+     * \brief The point of the segment closest to a point
+     *
+     * The projection of UnitLine::point_project clamped to the segment.
+     * @param p The point
+     * @return The closest point of the segment
+     */
+    PointVector closest_point(const PointVector &p) const noexcept;
+
+    /**
+     * \brief The point of the segment closest to a line
+     *
+     * The projection of UnitLine::point_project clamped to the segment.
+     * As the distance to a line is convex along the segment, the clamped point is the closest one.
+     * @param l The line
+     * @return The closest point of the segment
+     */
+    PointVector closest_point(const UnitLine &l) const noexcept;
+
+    /**
+     * \brief Distance between the segment and a point
+     * @param p The point
+     * @return The distance
+     */
+    double get_distance(const PointVector &p) const noexcept;
+
+    /**
+     * \brief Distance between the segment and a line
+     * @param l The line
+     * @return The distance
+     */
+    double get_distance(const UnitLine &l) const noexcept;
+
+    /**
+     * \brief The closest points between this and another segment
+     *
+     * The closest points of the lines are clamped to the segments and refined by projecting back and forth.
+     * For parallel segments one pair of the equally close points is chosen.
+     * @param s The other segment
+     * @return The point on this segment and the point on the other segment
+     */
+    std::pair<PointVector, PointVector> closest_points(const LineSegment &s) const noexcept;
+
+    /**
+     * \brief Distance to another segment
+     * @param s The other segment
+     * @return The distance
+     */
+    double get_distance(const LineSegment &s) const noexcept;
+};
+
+/**
+ * \brief All points within a radius around a segment
+ */
+class Capsule {
+private:
+    LineSegment segment; //!< The axis of the capsule
+    double size; //!< The radius of the capsule
+
+public:
+    /**
+     * \brief Create a capsule
+     * \exception std::invalid_argument If the radius is negative
+     * @param axis The axis of the capsule
+     * @param radius The radius of the capsule
+     */
+    Capsule(const LineSegment &axis, double radius);
+
+    /**
+     * \brief The axis of the capsule
+     * @return The axis
+     */
+    const LineSegment &axis() const noexcept;
+
+    /**
+     * \brief The radius of the capsule
+     * @return The radius
+     */
+    double radius() const noexcept;
+
+    /**
+     * \brief Clearance to another capsule
+     * @param c The other capsule
+     * @return The distance between the surfaces, negative if the capsules intersect
+     */
+    double get_distance(const Capsule &c) const noexcept;
+
+    /**
+     * \brief Check if the capsule touches another capsule
+     * @param c The other capsule
+     * @return True if the capsules intersect or touch
+     */
+    bool collides(const Capsule &c) const noexcept;
+};
+
+/**
+ * \brief Result of a batched segment distance query
+ */
+struct SegmentPair {
+    Eigen::Index first = -1; //!< Column of the segment in the first buffer, -1 if a buffer is empty
+    Eigen::Index second = -1; //!< Column of the segment in the second buffer, -1 if a buffer is empty
+    double distance = std::numeric_limits<double>::infinity(); //!< Distance of the segments
+};
+
+/**
+ * \brief Find the closest pair between two sets of segments
+ *
+ * All N x M pairs are tested, blocks of the second buffer at once.
+ * The search stops at the first block containing a pair closer than the threshold,
+ *   so a collision check can pass the clearance as threshold and only test the first index for -1.
+ * The function does not allocate.
+ * @param a The first segments
+ * @param b The second segments
+ * @param threshold Distance below which the search stops early
+ * @return The closest pair or the first found pair below the threshold
+ */
+SegmentPair closest_pair(const Eigen::Ref<const SegmentBuffer> &a, const Eigen::Ref<const SegmentBuffer> &b,
+                         double threshold = -std::numeric_limits<double>::infinity()) noexcept;
+
+/**
+ * \brief Find the closest pair between two sets of capsules
+ *
+ * As closest_pair for segments but the distances are the clearances of capsules around the segments.
+ * @param a The axes of the first capsules
+ * @param radius_a The radii of the first capsules
+ * @param b The axes of the second capsules
+ * @param radius_b The radii of the second capsules
+ * @param threshold Clearance below which the search stops early, 0 for a collision check
+ * @return The pair with the least clearance or the first found pair below the threshold
+ */
+SegmentPair closest_pair(const Eigen::Ref<const SegmentBuffer> &a, const Eigen::Ref<const Eigen::VectorXd> &radius_a,
+                         const Eigen::Ref<const SegmentBuffer> &b, const Eigen::Ref<const Eigen::VectorXd> &radius_b,
+                         double threshold = -std::numeric_limits<double>::infinity()) noexcept;
+
+#endif //DUAL_ALGEBRA_KINEMATICS_LINE_SEGMENT_H
@@ -0,0 +1,101 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_LINE_TABLE_H
+#define DUAL_ALGEBRA_KINEMATICS_LINE_TABLE_H
+
+#include <vector>
+
+#include "screw.h"
+#include "unit_line.h"
+
+/**
+ * \brief Relations and distances between all pairs of a set of lines
+ *
+ * The relations are classified by dot and cross products only:
+ *   the norm of the cross product of the directions separates parallel from non-parallel lines,
+ *   the sign of their dot product the orientation, and the translational distance the shared point.
+ * The translational distance of non-parallel lines is the reciprocal product divided by the sine of the angle,
+ *   for parallel lines it is the norm of the difference of the equally oriented moments, negated if anti parallel.
+ * The angles need an acos and are only computed if requested.
+ *
+ * The table is symmetric, thus only the upper triangle is computed in square tiles which are distributed over threads.
+ * The results agree with UnitLine::get_relation_to() and UnitLine::get_distance().
+ */
+class LineTable {
+private:
+    Eigen::Index count; //!< Number of lines
+    std::vector<LineRelation> relations; //!< Relations in column major order
+    Eigen::MatrixXd translations; //!< Signed translational distances
+    Eigen::MatrixXd rotations; //!< Angles, empty if not requested
+
+    /**
+     * \brief Fill the table
+     * @param lines The lines as normalized screws, one per column
+     * @param threads The number of threads
+     */
+    void compute(const Eigen::Ref<const ScrewBuffer> &lines, unsigned int threads);
+
+public:
+    /**
+     * \brief Compute the table of a set of lines
+     * @param lines The lines
+     * @param angles Whether the angles between the lines are computed as well
+     * @param threads The number of threads working on disjoint tiles of the table
+     */
+    explicit LineTable(const std::vector<UnitLine> &lines, bool angles = false, unsigned int threads = 1);
+
+    /**
+     * \brief Compute the table of a set of lines stored as screws
+     *
+     * The columns are expected to be lines, i.e. unit directions orthogonal to the moments. This is not checked.
+     * @param lines The lines with direction in the upper and moment in the lower three rows
+     * @param angles Whether the angles between the lines are computed as well
+     * @param threads The number of threads working on disjoint tiles of the table
+     */
+    explicit LineTable(const Eigen::Ref<const ScrewBuffer> &lines, bool angles = false, unsigned int threads = 1);
+
+    /**
+     * \brief Number of lines
+     * @return The number of lines
+     */
+    Eigen::Index size() const noexcept;
+
+    /**
+     * \brief The relation of two lines
+     * @param i Index of the first line
+     * @param j Index of the second line
+     * @return The relation as from UnitLine::get_relation_to()
+     */
+    LineRelation relation(Eigen::Index i, Eigen::Index j) const noexcept;
+
+    /**
+     * \brief The distance of two lines
+     * \exception std::logic_error If the table was computed without angles
+     * @param i Index of the first line
+     * @param j Index of the second line
+     * @return The distance as from UnitLine::get_distance()
+     */
+    DualNumberAlgebra::DualNumber distance(Eigen::Index i, Eigen::Index j) const;
+
+    /**
+     * \brief All translational distances
+     * @return The symmetric matrix of the dual parts of the distances
+     */
+    const Eigen::MatrixXd &translational_distances() const noexcept;
+
+    /**
+     * \brief All angles
+     * @return The symmetric matrix of the angles, empty if the table was computed without angles
+     */
+    const Eigen::MatrixXd &angles() const noexcept;
+
+    /**
+     * \brief Check if all distinct lines are skew to each other
+     * @return True if no pair of lines intersects or is parallel
+     */
+    bool general_position() const noexcept;
+};
+
+#endif //DUAL_ALGEBRA_KINEMATICS_LINE_TABLE_H
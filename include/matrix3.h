@@ -7,6 +7,8 @@
 
 #include <eigen3/Eigen/Eigen>
 
+#include "precision.h"
+
 class Vector;
 class DualEmbeddedMatrix;
 class DualFrame;
@@ -116,6 +118,16 @@ public:
      */
     static RotationMatrix RotationFromEigen(const Mat3 &data);
 
+    /**
+     * \brief Create a rotation matrix of raw data without the check
+     *
+     * Only for matrices which are known to be orthogonal with a positive determinant.
+     *
+     * @param data The rotationmatrix
+     * @return The rotation matrix
+     */
+    static RotationMatrix RotationFromEigen(const Mat3 &data, Unchecked) noexcept;
+
     /**
      * \brief Matrix-Matrix multiplication within rotation matrices.
      *
@@ -164,6 +176,15 @@ public:
      */
     explicit SkewMatrix(const Matrix3 & rhs);
 
+    /**
+     * Use the input as skew matrix without the check
+     *
+     * Only for matrices which are known to be skew matrices.
+     *
+     * @param rhs The skew matrix
+     */
+    SkewMatrix(const Matrix3 & rhs, Unchecked) noexcept;
+
     /**
      * Create a skew matrix from a vector.
      *
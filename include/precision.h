@@ -39,4 +39,20 @@ public:
     void operator=(Compare const &) = delete;
 };
 
+/**
+ * \brief Tag to select a constructor without the check of its invariant
+ *
+ * The checks are kept at the public interface.
+ * Library internal code which already knows that the invariant holds uses the tagged constructors,
+ *   e.g. for a direction read back from a line it just created.
+ */
+struct Unchecked {
+    explicit Unchecked() = default;
+};
+
+/**
+ * \brief The instance of the tag to pass to the unchecked constructors
+ */
+inline constexpr Unchecked unchecked{};
+
 #endif //DUAL_ALGEBRA_KINEMATICS_PRECISION_H
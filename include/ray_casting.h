@@ -0,0 +1,110 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_RAY_CASTING_H
+#define DUAL_ALGEBRA_KINEMATICS_RAY_CASTING_H
+
+#include <limits>
+#include <vector>
+
+#include "unit_line.h"
+#include "dual_frame.h"
+
+/**
+ * \brief Closest intersection of a ray with a mesh
+ */
+struct RayHit {
+    int face = -1; //!< Index of the hit triangle or polygon, -1 if nothing is hit
+    double distance = std::numeric_limits<double>::infinity(); //!< Distance along the ray in units of its direction
+};
+
+/**
+ * \brief Triangle index storage, one triangle per column
+ */
+using TriangleBuffer = Eigen::Matrix<int, 3, Eigen::Dynamic>;
+
+/**
+ * \brief Batch intersection of rays with a triangle mesh by pluecker side tests
+ *
+ * The edges of every triangle are stored as lines.
+ * A ray passes through a triangle if the reciprocal products, the dual part of Screw::operator*,
+ *   of the ray with all three edges have the same sign.
+ * The edges are normalized, which does not change the sign.
+ * Only for the triangles passing this test the distance to the plane of the triangle is computed.
+ *
+ * The edges are stored as structure of arrays, so the side tests of many triangles are evaluated vectorized.
+ */
+class RayCaster {
+private:
+    /**
+     * \brief Rows of the structure of arrays
+     *
+     * Three edges with direction and moment, the plane normal and the plane offset
+     */
+    static constexpr int ROWS = 22;
+
+    /**
+     * \brief Edge lines and planes with one triangle per column
+     */
+    Eigen::Array<double, ROWS, Eigen::Dynamic> triangles;
+
+    /**
+     * \brief The face reported for each triangle
+     */
+    std::vector<int> faces;
+
+public:
+    /**
+     * \brief Precompute the edges of a triangle mesh
+     *
+     * \exception std::invalid_argument If an index is out of range or a triangle is degenerated
+     * @param vertices The vertices of the mesh
+     * @param indices The vertex indices of the triangles
+     */
+    RayCaster(const Eigen::Ref<const PointBuffer> &vertices, const Eigen::Ref<const TriangleBuffer> &indices);
+
+    /**
+     * \brief Precompute the edges of a mesh of convex polygons
+     *
+     * The polygons are split into triangles which all report the index of their polygon.
+     * \exception std::invalid_argument If an index is out of range, a polygon has less than three vertices
+     *   or is degenerated
+     * @param vertices The vertices of the mesh
+     * @param polygons The vertex indices of each polygon in order
+     * @return The ray caster
+     */
+    static RayCaster FromPolygons(const Eigen::Ref<const PointBuffer> &vertices,
+                                  const std::vector<std::vector<int>> &polygons);
+
+    /**
+     * \brief Number of triangles
+     * @return The number of triangles after splitting the polygons
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * \brief Cast a single ray
+     *
+     * The ray starts at the origin and follows the line.
+     * The origin has to be on the line.
+     * @param ray The line of the ray
+     * @param origin The start of the ray
+     * @return The closest hit in front of the origin
+     */
+    RayHit cast(const UnitLine &ray, const PointVector &origin) const noexcept;
+
+    /**
+     * \brief Cast many rays
+     *
+     * The distance of a hit is given in units of the direction of the ray.
+     * @param origins The start points of the rays
+     * @param directions The directions of the rays, same size as origins
+     * @param hits Storage for one hit per ray
+     * @param threads The number of threads working on disjoint parts of the rays
+     */
+    void cast(const Eigen::Ref<const PointBuffer> &origins, const Eigen::Ref<const PointBuffer> &directions,
+              RayHit *hits, unsigned int threads = 1) const;
+};
+
+#endif //DUAL_ALGEBRA_KINEMATICS_RAY_CASTING_H
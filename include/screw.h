@@ -11,6 +11,7 @@ class AdjungateMatrix;
 
 class UnitLine;
 class DualEmbeddedMatrix;
+class DualFrame;
 
 class MomentVector;
 class DirectionVector;
@@ -18,6 +19,8 @@ class PointVector;
 
 class Projection;
 
+struct Unchecked;
+
 namespace DualNumberAlgebra{
     class DualNumber;
 }
@@ -54,6 +57,11 @@ protected:
      */
     explicit Screw(const Vec6 &data) noexcept;
 
+    /**
+     * \brief A friend so that the UnitLine can create screws with Eigen types
+     */
+    friend class UnitLine;
+
 public:
     /**
      * \brief Deleted default constructor
@@ -74,9 +82,18 @@ public:
 
     /**
      * \brief Return the direction vector
+     * \exception std::invalid_argument If the screw has no rotational part, e.g. a pure translation
      * @return The direction vector
      */
-    DirectionVector n() const noexcept;
+    DirectionVector n() const;
+
+    /**
+     * \brief Return the direction vector without the check for the null vector
+     *
+     * Only for library internal code where the direction is known to be nonzero or a zero direction is handled.
+     * @return The direction vector, may be zero
+     */
+    DirectionVector n(Unchecked) const noexcept;
 
     /**
      * \brief Return the moment vector
@@ -97,6 +114,18 @@ public:
      */
     DualNumberAlgebra::DualNumber operator*(const Screw &rhs) const noexcept;
 
+    /**
+     * \brief Calculate the scalar triple product between screws as dual vectors
+     *
+     * This is \f$ s \cdot (b \times c) \f$ with the dual cross product of Screw::ad,
+     *   but neither the bracket nor an embedded skew is built.
+     *
+     * @param b The first screw of the cross product
+     * @param c The second screw of the cross product
+     * @return The triple product of this, b and c
+     */
+    DualNumberAlgebra::DualNumber triple(const Screw &b, const Screw &c) const noexcept;
+
     /**
      * \brief Calculate a norm of the skew
      *
@@ -150,6 +179,34 @@ public:
      */
     Screw operator-(const Screw &rhs) const;
 
+    /**
+     * \brief The adjoint action of the screw on another screw, which is the lie bracket
+     *
+     * In pluecker coordinates this is the dual cross product of the screws as dual vectors:
+     *
+     * \f$ [a, b] = (n_a \times n_b) + \epsilon (n_a \times m_b + m_a \times n_b) \f$
+     *
+     * This is the same as the commutator of the embedded skews but with cross products only.
+     *
+     * \exception std::domain_error If the resulting direction would be zero, e.g. for parallel screws
+     * @param rhs right-hand-side
+     * @return The lie bracket
+     */
+    Screw ad(const Screw &rhs) const;
+
+    /**
+     * \brief The adjoint of a frame applied to the screw
+     *
+     * This is the transformation of the screw to the frame calculated with the rotation and the skewed translation
+     *   of the frame instead of the whole embedded matrix:
+     *
+     * \f$ n' = R n \quad m' = R m + [p]_\times R n \f$
+     *
+     * @param frame The transforming frame
+     * @return The transformed screw
+     */
+    Screw Ad(const DualFrame &frame) const noexcept;
+
     /**
      * \brief Align and normalize the screw.
      *
@@ -171,6 +228,15 @@ public:
      */
     friend Screw operator*(const DualEmbeddedMatrix &lhs, const Screw &rhs) noexcept;
 
+    /**
+     * \brief The lie bracket of a screw with many screws
+     * @param lhs The left-hand-side screw of each bracket
+     * @param screws The right-hand-side screws
+     * @param result Storage for the brackets
+     */
+    friend void ad(const Screw &lhs, const Eigen::Ref<const Eigen::Matrix<double, 6, Eigen::Dynamic>> &screws,
+                   Eigen::Ref<Eigen::Matrix<double, 6, Eigen::Dynamic>> result) noexcept;
+
     /**
      * \brief Check for equality element-wise
      * @param lhs left-hand-side
@@ -196,4 +262,34 @@ public:
     friend std::ostream &operator<<(std::ostream &stream, const Screw &rhs);
 };
 
+/**
+ * \brief Column-wise storage of many screws
+ *
+ * Each column is a screw with the direction in the upper and the moment in the lower three rows.
+ * Twists and wrenches in pluecker coordinates (rotation or force first) share this layout and transform alike.
+ */
+using ScrewBuffer = Eigen::Matrix<double, 6, Eigen::Dynamic>;
+
+/**
+ * \brief The adjoint of a frame applied to many screws
+ *
+ * \see Screw::Ad
+ * @param frame The transforming frame
+ * @param screws The screws to transform, e.g. twists or wrenches
+ * @param result Storage for the transformed screws, has to have the same size as screws
+ */
+void Ad(const DualFrame &frame, const Eigen::Ref<const ScrewBuffer> &screws, Eigen::Ref<ScrewBuffer> result) noexcept;
+
+/**
+ * \brief The lie bracket of a screw with many screws
+ *
+ * Different to Screw::ad the resulting directions may be zero.
+ *
+ * \see Screw::ad
+ * @param lhs The left-hand-side screw of each bracket
+ * @param screws The right-hand-side screws
+ * @param result Storage for the brackets, has to have the same size as screws
+ */
+void ad(const Screw &lhs, const Eigen::Ref<const ScrewBuffer> &screws, Eigen::Ref<ScrewBuffer> result) noexcept;
+
 #endif //DUAL_ALGEBRA_KINEMATICS_SCREW_H
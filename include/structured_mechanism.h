@@ -0,0 +1,176 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_STRUCTURED_MECHANISM_H
+#define DUAL_ALGEBRA_KINEMATICS_STRUCTURED_MECHANISM_H
+
+#include <stdexcept>
+#include <vector>
+
+#include "ccc.h"
+#include "precision.h"
+
+/**
+ * \brief Compile-time known direction of a joint line
+ *
+ * Lines with a positive coordinate axis as direction create rotation matrices with a lot of structural zeros.
+ * Any other direction has to be declared as AXIS_ANY.
+ */
+enum Axis {
+    AXIS_X = 0, ///< The line direction is (1,0,0)
+    AXIS_Y = 1, ///< The line direction is (0,1,0)
+    AXIS_Z = 2, ///< The line direction is (0,0,1)
+    AXIS_ANY = 3 ///< Arbitrary line direction
+};
+
+/**
+ * \brief Transformation kernel of a single joint with a compile-time known direction
+ *
+ * The kernel appends the transformation around the line to a frame given by its rotation and translation.
+ * For coordinate axes, only the two columns of the rotation matrix orthogonal to the axis are touched.
+ *
+ * @tparam A The direction of the joint line
+ */
+template<Axis A>
+class StructuredJoint {
+private:
+    using Vec3 = Eigen::Matrix<double, 3, 1>; //!< Eigen 3x1 vector
+    using Mat3 = Eigen::Matrix<double, 3, 3>; //!< Eigen 3x3 matrix
+
+    Vec3 n; //!< The direction of the line
+    Vec3 anchor; //!< The canonical anchor of the line
+    Mat3 k; //!< The skew of the direction, only used for AXIS_ANY
+
+public:
+    /**
+     * \brief Create the kernel for a line
+     * \exception std::invalid_argument If the line does not have the declared direction
+     * @param line The joint line
+     */
+    explicit StructuredJoint(const UnitLine &line) : n(line.n().get()), anchor(line.get_canonical_anchor().get()) {
+        if constexpr (A != AXIS_ANY) {
+            if (!Compare::is_equal(this->n(A), 1.0)) {
+                throw std::invalid_argument("Line direction does not match the declared axis");
+            }
+        }
+        this->k << 0, -n(2), n(1),
+                n(2), 0, -n(0),
+                -n(1), n(0), 0;
+    }
+
+    /**
+     * \brief Append the joint transformation to a frame
+     *
+     * Calculates (R, p) = (R, p) * M(phi) with the rodriguez formula M(phi) of the joint line.
+     *
+     * @param R The rotation of the frame
+     * @param p The translation of the frame
+     * @param phi The joint value
+     */
+    void apply(Mat3 &R, Vec3 &p, const DualNumberAlgebra::DualNumber &phi) const noexcept {
+        const double c = std::cos(phi.real());
+        const double s = std::sin(phi.real());
+
+        if constexpr (A == AXIS_ANY) {
+            Mat3 rotation = Mat3::Identity() + s * this->k + (1 - c) * this->k * this->k;
+            p += R * (this->anchor - rotation * this->anchor + phi.dual() * this->n);
+            R = R * rotation;
+        } else {
+            // The rotation around the axis only mixes the two other coordinates
+            constexpr int i = (A + 1) % 3;
+            constexpr int j = (A + 2) % 3;
+
+            // The translation (I - rotation) * anchor + d * n has no rotational part along the axis
+            const double t_i = this->anchor(i) - (c * this->anchor(i) - s * this->anchor(j));
+            const double t_j = this->anchor(j) - (s * this->anchor(i) + c * this->anchor(j));
+            p += t_i * R.col(i) + t_j * R.col(j) + phi.dual() * R.col(A);
+
+            Vec3 col_i = R.col(i);
+            R.col(i) = c * col_i + s * R.col(j);
+            R.col(j) = c * R.col(j) - s * col_i;
+        }
+    }
+};
+
+/**
+ * \brief A CCC mechanism with compile-time declared line directions
+ *
+ * Only the forward kinematics is generated for the declared structure and skips the structural zeros.
+ * The inverse kinematics is not specialized and forwards to the CCCMechanism.
+ *
+ * @tparam A1 The direction of the first line
+ * @tparam A2 The direction of the second line
+ * @tparam A3 The direction of the third line
+ */
+template<Axis A1, Axis A2, Axis A3>
+class StructuredCCCMechanism {
+private:
+    CCCMechanism mechanism; //!< The generic mechanism
+    StructuredJoint<A1> j1; //!< Kernel of the first joint
+    StructuredJoint<A2> j2; //!< Kernel of the second joint
+    StructuredJoint<A3> j3; //!< Kernel of the third joint
+    Eigen::Matrix<double, 3, 3> zero_R; //!< Rotation of the zero posture
+    Eigen::Matrix<double, 3, 1> zero_p; //!< Translation of the zero posture
+
+public:
+    /**
+     * \brief Create the structured mechanism from a generic one
+     * \exception std::invalid_argument If a line does not have the declared direction
+     * @param mechanism The generic mechanism
+     */
+    explicit StructuredCCCMechanism(const CCCMechanism &mechanism)
+        : mechanism(mechanism), j1(mechanism.l12), j2(mechanism.l23), j3(mechanism.l34),
+          zero_R(mechanism.zero_posture.R().get()), zero_p(mechanism.zero_posture.p().get()) {}
+
+    /**
+     * \brief Create the structured mechanism like a CCCMechanism
+     * \exception std::invalid_argument If a line does not have the declared direction
+     * @param l12 First C joint
+     * @param l23 Second C joint
+     * @param l34 Third C joint
+     * @param zero_posture Endeffector pose in zeroed joint values
+     */
+    StructuredCCCMechanism(const UnitLine &l12, const UnitLine &l23, const UnitLine &l34, const DualFrame &zero_posture)
+        : StructuredCCCMechanism(CCCMechanism(l12, l23, l34, zero_posture)) {}
+
+    /**
+     * \brief Forward kinematics with the structured kernels
+     * @param config The joint configuration to calculate the endeffector pose
+     * @return The endeffector pose
+     */
+    DualFrame forward(const Configuration &config) const {
+        Eigen::Matrix<double, 3, 3> R = Eigen::Matrix<double, 3, 3>::Identity();
+        Eigen::Matrix<double, 3, 1> p = Eigen::Matrix<double, 3, 1>::Zero();
+
+        this->j1.apply(R, p, config.phi_1);
+        this->j2.apply(R, p, config.phi_2);
+        this->j3.apply(R, p, config.phi_3);
+
+        p += R * this->zero_p;
+        R = R * this->zero_R;
+
+        return DualFrame(RotationMatrix::RotationFromEigen(R, unchecked), PointVector(Vector(p)));
+    }
+
+    /**
+     * \brief The inverse kinematics of the generic mechanism
+     * \see CCCMechanism::inverse
+     * \exception std::domain_error If no solution is possible
+     * @param pose The frame to reach
+     * @return A list with possible configurations
+     */
+    std::vector<Configuration> inverse(const DualFrame &pose) const {
+        return this->mechanism.inverse(pose);
+    }
+
+    /**
+     * \brief The generic mechanism
+     * @return The mechanism without structure
+     */
+    const CCCMechanism &generic() const noexcept {
+        return this->mechanism;
+    }
+};
+
+#endif //DUAL_ALGEBRA_KINEMATICS_STRUCTURED_MECHANISM_H
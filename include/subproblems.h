@@ -0,0 +1,128 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_SUBPROBLEMS_H
+#define DUAL_ALGEBRA_KINEMATICS_SUBPROBLEMS_H
+
+#include <vector>
+#include <utility>
+
+#include "dual_number.h"
+#include "unit_line.h"
+
+/**
+ * \brief Type of a joint of a line mechanism
+ *
+ * A C joint can be locked to a revolute or a prismatic joint by a zero dual or real part of its value.
+ */
+enum JointType {
+    CYLINDRICAL, ///< Rotation and translation along the line
+    REVOLUTE, ///< Only rotation around the line, the dual part is zero
+    PRISMATIC ///< Only translation along the line, the real part is zero
+};
+
+/**
+ * \brief Paden-Kahan like subproblems formulated with lines
+ *
+ * The classical subproblems rotate points around axes.
+ * Here, lines are transformed around lines by dual angles.
+ * Thus a revolute axis is a line with a pure real angle and a prismatic axis is a line with a pure dual angle.
+ */
+namespace Subproblem {
+    /**
+     * \brief Find the transformation around the axis moving the line a onto the line b
+     *
+     * This is the first subproblem and solved by UnitLine::acos3.
+     * It is only solvable if both lines have the same dual angle to the axis.
+     *
+     * \exception std::domain_error If b cannot be reached by transforming a around the axis
+     * @param axis The transformation axis
+     * @param a The line to move
+     * @param b The goal line
+     * @return The dual angle around the axis
+     */
+    DualNumberAlgebra::DualNumber transform_onto(const UnitLine &axis, const UnitLine &a, const UnitLine &b);
+
+    /**
+     * \brief Find the transformation of a locked joint around the axis moving the line a towards the line b
+     *
+     * The first subproblem for joints with a zero dual or real part.
+     * A revolute joint only needs the real angle between the directions of a and b around the axis.
+     * A prismatic joint only needs the translation, which changes the moment of a linearly.
+     * A cylindrical joint is solved by UnitLine::acos3.
+     *
+     * In contrast to transform_onto(const UnitLine &, const UnitLine &, const UnitLine &) b is not checked.
+     * The result is the transformation of the joint type which reaches b if b is reachable at all.
+     * If a is parallel to the axis, a translation does not move a and thus the prismatic result is zero.
+     *
+     * @param axis The transformation axis
+     * @param a The line to move
+     * @param b The goal line
+     * @param type The type of the joint around the axis
+     * @return The dual angle around the axis with a zero dual part for revolute and a zero real part for prismatic joints
+     */
+    DualNumberAlgebra::DualNumber transform_onto(const UnitLine &axis, const UnitLine &a, const UnitLine &b,
+                                                 JointType type) noexcept;
+
+    /**
+     * \brief Find the transformations around two axes moving the line a onto the line b
+     *
+     * This is the second subproblem.
+     * The line a is first transformed around the second axis and then around the first axis:
+     *
+     * \f$ M_1(\varphi_1) M_2(\varphi_2) a = b \f$
+     *
+     * The second angle is the solution of a dual trigonometric equation, the first one is given by
+     *   transform_onto.
+     *
+     * \exception std::domain_error If the trigonometric equation has no solution
+     * @param first The axis transforming last
+     * @param second The axis transforming first
+     * @param a The line to move
+     * @param b The goal line
+     * @return Pairs of dual angles around the first and the second axis
+     */
+    std::vector<std::pair<DualNumberAlgebra::DualNumber, DualNumberAlgebra::DualNumber>>
+    transform_onto(const UnitLine &first, const UnitLine &second, const UnitLine &a, const UnitLine &b);
+
+    /**
+     * \brief Find the transformations around the axis such that the line a reaches a dual angle to the line b
+     *
+     * This is the third subproblem.
+     * The distance is given as the dual angle of UnitLine::get_distance.
+     *
+     * \exception std::domain_error If the distance cannot be reached
+     * @param axis The transformation axis
+     * @param a The line to move
+     * @param b The reference line
+     * @param distance The dual angle between the transformed a and b
+     * @return The dual angles around the axis
+     */
+    std::vector<DualNumberAlgebra::DualNumber>
+    transform_to_distance(const UnitLine &axis, const UnitLine &a, const UnitLine &b, const DualNumberAlgebra::DualNumber &distance);
+
+    /**
+     * \brief Find the transformations of a locked joint around the axis such that a reaches a dual angle to b
+     *
+     * The third subproblem for joints with a zero dual or real part.
+     * A revolute joint only solves the real part of the trigonometric equation.
+     * The dual part of the distance is not checked as a rotation alone cannot adjust it.
+     * A prismatic joint turns the trigonometric equation into a linear one for the translation.
+     * The real part of the distance is not checked as a translation alone cannot adjust it.
+     * A cylindrical joint is solved like transform_to_distance(const UnitLine &, const UnitLine &, const UnitLine &, const DualNumberAlgebra::DualNumber &).
+     *
+     * \exception std::domain_error If the distance cannot be reached or does not depend on the translation of a prismatic joint
+     * @param axis The transformation axis
+     * @param a The line to move
+     * @param b The reference line
+     * @param distance The dual angle between the transformed a and b
+     * @param type The type of the joint around the axis
+     * @return The dual angles around the axis with a zero dual part for revolute and a zero real part for prismatic joints
+     */
+    std::vector<DualNumberAlgebra::DualNumber>
+    transform_to_distance(const UnitLine &axis, const UnitLine &a, const UnitLine &b, const DualNumberAlgebra::DualNumber &distance,
+                          JointType type);
+}
+
+#endif //DUAL_ALGEBRA_KINEMATICS_SUBPROBLEMS_H
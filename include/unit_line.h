@@ -6,6 +6,8 @@
 #define DUAL_ALGEBRA_KINEMATICS_UNIT_LINE_H
 
 #include "screw.h"
+#include "precision.h"
+#include "dual_number.h"
 
 /**
  * \brief Description of the relationship between lines
@@ -19,9 +21,11 @@ enum LineRelation {
     ANTI_COINCIDE ///< Coinciding lines with opposite orientation
 };
 
+class Vector;
 class UnitDirectionVector;
 
 class DualFrame;
+struct LineData;
 
 /**
  * \brief A screw without a pitch and a unit direction
@@ -42,6 +46,25 @@ protected:
      */
     explicit UnitLine(const Vec6 &data) noexcept;
 
+    /**
+     * \brief Compute the orthogonal between two screws without an exception
+     *
+     * This is the same as UnitLine::orthogonal but reports coinciding lines by the return value.
+     * @param l Screw to find the common orthogonal to
+     * @param result Storage for the orthogonal, only written if there is one
+     * @return False if the lines are coinciding and there is no orthogonal
+     */
+    bool find_orthogonal(const Screw &l, Vec6 &result) const noexcept;
+
+    /**
+     * \brief Compute the orthogonal direction of two lines without an exception
+     *
+     * This is the same as UnitLine::line_cross but the result is zero for coinciding lines.
+     * @param rhs right-hand-side
+     * @return The orthogonal direction of both lines or zero
+     */
+    Vector find_line_cross(const UnitLine &rhs) const noexcept;
+
 public:
     /**
     * \brief Construction of the unit line with unit direction and anchor point
@@ -60,6 +83,16 @@ public:
     */
     explicit UnitLine(const UnitDirectionVector &n, const MomentVector &m);
 
+    /**
+    * \brief Construction of the unit line with unit direction and moment without the check
+    *
+    * Only for moments which are known to be orthogonal to the direction.
+    *
+    * @param n The unit direction vector
+    * @param m The moment vector
+    */
+    UnitLine(const UnitDirectionVector &n, const MomentVector &m, Unchecked) noexcept;
+
     /**
     * \brief Construction of the unit line with direction and anchor point
     *
@@ -281,7 +314,50 @@ public:
      * @return The line transformed by the frame
      */
     friend UnitLine operator*(const DualFrame &lhs, const UnitLine &rhs) noexcept;
+
+    /**
+     * \brief Store the line as plain data
+     * @param line The line
+     * @return The plain data of the line
+     */
+    friend LineData to_data(const UnitLine &line) noexcept;
+
+    /**
+     * \brief Restore a line from plain data without any check
+     * @param data The plain data
+     * @return The line
+     */
+    friend UnitLine to_line(const LineData &data) noexcept;
 };
 
+/**
+ * \brief UnitLine::acos3 for many line pairs around one reference line
+ *
+ * The same computation as UnitLine::acos3 without constructing orthogonal screws and lines,
+ *   evaluated on blocks of columns by array operations without branches.
+ * The degeneracies are handled alike: if the reference coincides with a or b the result is 0+0ϵ,
+ *   and if a or b is parallel to the reference the translation is 0.
+ * The columns are expected to be lines, i.e. unit directions orthogonal to the moments. This is not checked.
+ * @param reference The line to rotate and translate around
+ * @param a The lines a, one per column
+ * @param b The lines b, one per column
+ * @param result Storage for the angles and translations, has to have as many columns as a and b
+ */
+void acos3_batch(const UnitLine &reference, const Eigen::Ref<const ScrewBuffer> &a,
+                 const Eigen::Ref<const ScrewBuffer> &b, Eigen::Ref<DualBuffer> result) noexcept;
+
+/**
+ * \brief UnitLine::acos3 for many line pairs stored in plain arrays
+ *
+ * Each line is given by 6 doubles, the direction followed by the moment.
+ * @param reference The line to rotate and translate around
+ * @param a Pointer to 6 * count doubles
+ * @param b Pointer to 6 * count doubles
+ * @param result Pointer to 2 * count doubles, the angle followed by the translation of each pair
+ * @param count Number of line pairs
+ */
+void acos3_batch(const UnitLine &reference, const double *a, const double *b, double *result,
+                 std::size_t count) noexcept;
+
 
 #endif //DUAL_ALGEBRA_KINEMATICS_UNIT_LINE_H
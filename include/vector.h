@@ -7,6 +7,8 @@
 
 #include <eigen3/Eigen/Eigen>
 
+#include "precision.h"
+
 class Matrix3;
 class SkewMatrix;
 class Screw;
@@ -238,6 +240,24 @@ public:
      */
     DirectionVector(double a, double b, double c);
 
+    /**
+     * \brief Conversion constructor from a Vector without the check
+     *
+     * Only for vectors which are known to be no null vector.
+     * @param rhs Vector to treat as a direction vector
+     */
+    DirectionVector(const Vector &rhs, Unchecked) noexcept;
+
+    /**
+     * \brief Create a direction vector directly from its elements without the check
+     *
+     * Only for elements which are known to be no null vector.
+     * @param a First element
+     * @param b Second element
+     * @param c Third element
+     */
+    DirectionVector(double a, double b, double c, Unchecked) noexcept;
+
     /**
      * \brief Return the normalized version of the DirectionVector
      * This one hides the parent method to change the return type
@@ -269,6 +289,14 @@ public:
      */
     UnitDirectionVector(double a, double b, double c);
 
+    /**
+     * \brief Conversion constructor from a Vector without the check
+     *
+     * Only for vectors which are known to be normalized.
+     * @param rhs Vector to treat as a unit direction vector
+     */
+    UnitDirectionVector(const Vector &rhs, Unchecked) noexcept;
+
     /**
      * \brief Return the normalized vector
      *
@@ -4,6 +4,7 @@
 
 #include "dual_number.h"
 #include <iostream>
+#include <limits>
 #include "precision.h"
 
 namespace DualNumberAlgebra {
@@ -173,13 +174,22 @@ namespace DualNumberAlgebra {
     // LCOV_EXCL_STOP
 
     std::vector<DualNumber> solve_trigonometric_equation(const DualNumber &cos_factor,const DualNumber &sin_factor, const DualNumber &offset) {
+        std::array<DualNumber, 2> solutions;
+        auto count = solve_trigonometric_equation(cos_factor, sin_factor, offset, solutions);
+        if (count == 0) {
+            throw std::domain_error("No solution possible");
+        }
+        return std::vector<DualNumber>(solutions.begin(), solutions.begin() + count);
+    }
+
+    std::size_t solve_trigonometric_equation(const DualNumber &cos_factor,const DualNumber &sin_factor, const DualNumber &offset, std::array<DualNumber, 2> &solutions) noexcept {
         DualNumber dd = cos_factor * cos_factor +
                         sin_factor * sin_factor -
                         offset * offset;
 
         if (!Compare::is_zero(dd.real())) {
             if (dd.real() < 0) {
-                throw std::domain_error("No solution possible");
+                return 0;
             }
         }
 
@@ -188,11 +198,66 @@ namespace DualNumberAlgebra {
         if(Compare::is_zero(dd.real())) {
             // there is some problems with calculation d = sqrt(dd) if dd has a zero real part
             // but luckily d is not necessary if the real part is zero
-            return {pre};
+            solutions[0] = pre;
+            return 1;
         } else {
             DualNumber d = DualNumberAlgebra::sqrt(dd);
             DualNumber rad = atan2(d, offset);
-            return {pre + rad, pre - rad};
+            solutions[0] = pre + rad;
+            solutions[1] = pre - rad;
+            return 2;
+        }
+    }
+
+    namespace {
+        constexpr Eigen::Index lane_width = 64;
+        using Lane = Eigen::Array<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, lane_width>;
+
+        Lane lane_atan2(const Lane &y, const Lane &x) noexcept {
+            return y.binaryExpr(x, [](double a, double b) { return real_atan2(a, b); });
+        }
+    }
+
+    void solve_trigonometric_equations(const Eigen::Ref<const DualBuffer> &cos_factors,
+                                       const Eigen::Ref<const DualBuffer> &sin_factors,
+                                       const Eigen::Ref<const DualBuffer> &offsets,
+                                       Eigen::Ref<DualBuffer> first, Eigen::Ref<DualBuffer> second,
+                                       Eigen::Ref<Eigen::VectorXi> counts) noexcept {
+        const double epsilon = Compare::instance().get_precision();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+
+        for (Eigen::Index start = 0; start < cos_factors.cols(); start += lane_width) {
+            const Eigen::Index width = std::min(lane_width, cos_factors.cols() - start);
+
+            // Split real and dual parts into contiguous arrays
+            const Lane ar = cos_factors.block(0, start, 1, width).array();
+            const Lane ad = cos_factors.block(1, start, 1, width).array();
+            const Lane br = sin_factors.block(0, start, 1, width).array();
+            const Lane bd = sin_factors.block(1, start, 1, width).array();
+            const Lane cr = offsets.block(0, start, 1, width).array();
+            const Lane cd = offsets.block(1, start, 1, width).array();
+
+            // Discriminant a * a + b * b - c * c
+            const Lane ddr = ar * ar + br * br - cr * cr;
+            const Lane ddd = 2 * (ar * ad + br * bd - cr * cd);
+            const auto single = ddr.abs() < epsilon;
+            const auto valid = single || ddr > 0;
+
+            // pre = atan2(b, a)
+            const Lane pre_r = lane_atan2(br, ar);
+            const Lane pre_d = (ar * bd - ad * br) / (ar * ar + br * br);
+
+            // rad = atan2(sqrt(dd), c), zero for a vanishing discriminant
+            const Lane dr = ddr.max(0.0).sqrt();
+            const Lane dd = 0.5 * ddd / dr;
+            const Lane rad_r = single.select(Lane::Zero(width), lane_atan2(dr, cr));
+            const Lane rad_d = single.select(Lane::Zero(width), (cr * dd - cd * dr) / (cr * cr + dr * dr));
+
+            first.block(0, start, 1, width) = valid.select(pre_r + rad_r, nan).matrix();
+            first.block(1, start, 1, width) = valid.select(pre_d + rad_d, nan).matrix();
+            second.block(0, start, 1, width) = valid.select(pre_r - rad_r, nan).matrix();
+            second.block(1, start, 1, width) = valid.select(pre_d - rad_d, nan).matrix();
+            counts.segment(start, width) = (valid.cast<int>() + (valid && !single).cast<int>()).matrix().transpose();
         }
     }
 
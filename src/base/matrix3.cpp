@@ -67,6 +67,8 @@ SkewMatrix::SkewMatrix(const Matrix3 & rhs) : Matrix3(rhs) {
     }
 }
 
+SkewMatrix::SkewMatrix(const Matrix3 & rhs, Unchecked) noexcept : Matrix3(rhs) {}
+
 RotationMatrix RotationMatrix::RotationFromEigen(const Matrix3::Mat3 &data) {
     auto check = (Matrix3::Mat3::Identity(3,3) - data * data.transpose()).array().abs();
     if ( ! (check< Compare::instance().get_precision()).all() ) {
@@ -79,3 +81,7 @@ RotationMatrix RotationMatrix::RotationFromEigen(const Matrix3::Mat3 &data) {
 
     return RotationMatrix(data);
 }
+
+RotationMatrix RotationMatrix::RotationFromEigen(const Matrix3::Mat3 &data, Unchecked) noexcept {
+    return RotationMatrix(data);
+}
@@ -113,6 +113,10 @@ DirectionVector::DirectionVector(double a, double b, double c) : Vector(a,b,c) {
     }
 }
 
+DirectionVector::DirectionVector(const Vector &rhs, Unchecked) noexcept : Vector(rhs) {}
+
+DirectionVector::DirectionVector(double a, double b, double c, Unchecked) noexcept : Vector(a,b,c) {}
+
 UnitDirectionVector
 DirectionVector::normal() const {
     return UnitDirectionVector(*this / this->norm());
@@ -130,6 +134,8 @@ UnitDirectionVector::UnitDirectionVector(double a, double b, double c) : Directi
     }
 }
 
+UnitDirectionVector::UnitDirectionVector(const Vector &rhs, Unchecked) noexcept : DirectionVector(rhs, unchecked) {}
+
 UnitDirectionVector
 UnitDirectionVector::normal() const {
     return *this;
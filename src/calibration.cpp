@@ -0,0 +1,202 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "calibration.h"
+
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+#include "vector.h"
+#include "matrix3.h"
+#include "dual_skew_product.h"
+#include "precision.h"
+#include "util/parallel.h"
+
+namespace {
+    constexpr int PARAMETERS = 18;
+
+    using Twist = Eigen::Matrix<double, 6, 1>;
+    using LineBasis = Eigen::Matrix<double, 6, 4>;
+    using Jacobian = Eigen::Matrix<double, 6, PARAMETERS>;
+    using Normal = Eigen::Matrix<double, PARAMETERS, PARAMETERS>;
+    using Gradient = Eigen::Matrix<double, PARAMETERS, 1>;
+
+    /**
+     * \brief The frame of a twist by the closed form of DualFrame(const DualSkewProduct &)
+     *
+     * The twist is split into its line and dual angle.
+     * Twists with a negligible rotation are a translation along a line through the origin.
+     */
+    DualFrame exp(const Twist &twist) noexcept {
+        const Eigen::Vector3d w = twist.head<3>();
+        const Eigen::Vector3d v = twist.tail<3>();
+        const double angle = w.norm();
+
+        const double epsilon = Compare::instance().get_precision();
+        if (angle <= epsilon * epsilon) {
+            const double distance = v.norm();
+            if (distance == 0) {
+                return DualFrame(RotationMatrix(0, 0, 0), PointVector(0, 0, 0));
+            }
+            return DualFrame(DualSkewProduct(UnitLine(UnitDirectionVector(Vector(v / distance), unchecked), PointVector(0, 0, 0)),
+                                             DualNumberAlgebra::DualNumber(0, distance)));
+        }
+
+        const Eigen::Vector3d n = w / angle;
+        const double translation = n.dot(v);
+        const UnitLine line(UnitDirectionVector(Vector(n), unchecked), MomentVector(Vector((v - translation * n) / angle)),
+                            unchecked);
+        return DualFrame(DualSkewProduct(line, DualNumberAlgebra::DualNumber(angle, translation)));
+    }
+
+    /**
+     * \brief The twist of a frame, the inverse of exp
+     */
+    Twist log(const DualFrame &frame) noexcept {
+        auto product = frame.constructive_line();
+        auto line = product.skew().screw();
+        auto angle = product.angle();
+        Twist result;
+        result << angle.real() * line.n().get(),
+                  angle.real() * line.m().get() + angle.dual() * line.n().get();
+        return result;
+    }
+
+    /**
+     * \brief The twists moving a line which do not leave it on itself
+     */
+    LineBasis basis(const UnitLine &line) noexcept {
+        const Eigen::Vector3d n = line.n().get();
+        const Eigen::Vector3d anchor = line.get_canonical_anchor().get();
+        const Eigen::Vector3d u = n.unitOrthogonal();
+        const Eigen::Vector3d v = n.cross(u);
+
+        LineBasis result;
+        result << u, v, Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero(),
+                  anchor.cross(u), anchor.cross(v), u, v;
+        return result;
+    }
+
+    /**
+     * \brief Normal equations and squared error of a mechanism
+     */
+    struct Accumulator {
+        Normal normal = Normal::Zero();
+        Gradient gradient = Gradient::Zero();
+        double squared_error = 0;
+
+        void merge(const Accumulator &other) noexcept {
+            this->normal += other.normal;
+            this->gradient += other.gradient;
+            this->squared_error += other.squared_error;
+        }
+    };
+
+    Accumulator accumulate(const CCCMechanism &mechanism, const std::vector<CalibrationSample> &samples,
+                           bool with_jacobian, unsigned int threads) {
+        const LineBasis b12 = basis(mechanism.l12);
+        const LineBasis b23 = basis(mechanism.l23);
+        const LineBasis b34 = basis(mechanism.l34);
+
+        Accumulator total;
+        std::mutex mutex;
+        parallel_columns(static_cast<Eigen::Index>(samples.size()), threads, [&](Eigen::Index start, Eigen::Index width) {
+            Accumulator part;
+            Jacobian J;
+            LineBasis moved;
+            for (Eigen::Index i = start; i < start + width; i++) {
+                const auto &sample = samples[i];
+                const DualFrame m1(DualSkewProduct(mechanism.l12, sample.configuration.phi_1));
+                const DualFrame m2(DualSkewProduct(mechanism.l23, sample.configuration.phi_2));
+                const DualFrame m3(DualSkewProduct(mechanism.l34, sample.configuration.phi_3));
+                const DualFrame m12 = m1 * m2;
+                const DualFrame m123 = m12 * m3;
+
+                const Twist residual = log(sample.pose * (m123 * mechanism.zero_posture).inverse());
+                part.squared_error += residual.squaredNorm();
+                if (!with_jacobian) {
+                    continue;
+                }
+
+                // The columns are the differences of the basis twists moved by the preceding joints
+                Ad(m1, b12, moved);
+                J.middleCols<4>(0) = b12 - moved;
+                Ad(m1, b23, moved);
+                J.middleCols<4>(4) = moved;
+                Ad(m12, b23, moved);
+                J.middleCols<4>(4) -= moved;
+                Ad(m12, b34, moved);
+                J.middleCols<4>(8) = moved;
+                Ad(m123, b34, moved);
+                J.middleCols<4>(8) -= moved;
+                J.middleCols<6>(12) = m123.embedded().get();
+
+                part.normal.noalias() += J.transpose() * J;
+                part.gradient.noalias() += J.transpose() * residual;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            total.merge(part);
+        }, 256);
+        return total;
+    }
+
+    CCCMechanism update(const CCCMechanism &mechanism, const Gradient &step) noexcept {
+        return CCCMechanism(
+                exp(basis(mechanism.l12) * step.segment<4>(0)) * mechanism.l12,
+                exp(basis(mechanism.l23) * step.segment<4>(4)) * mechanism.l23,
+                exp(basis(mechanism.l34) * step.segment<4>(8)) * mechanism.l34,
+                exp(step.segment<6>(12)) * mechanism.zero_posture);
+    }
+}
+
+CalibrationResult calibrate(const CCCMechanism &initial, const std::vector<CalibrationSample> &samples,
+                            std::size_t iterations, unsigned int threads) {
+    if (samples.size() < 3) {
+        throw std::invalid_argument("At least three samples are necessary for the eighteen parameters");
+    }
+
+    CalibrationResult result{initial, 0, 0, RefinementState::MAX_ITERATIONS};
+    Accumulator current = accumulate(result.mechanism, samples, true, threads);
+    const double epsilon = Compare::instance().get_precision();
+    double damping = 1e-3;
+
+    while (result.iterations < iterations) {
+        result.iterations++;
+
+        // Levenberg-Marquardt step with the diagonal of the normal equations as scaling
+        Normal damped = current.normal;
+        damped.diagonal() += damping * (current.normal.diagonal().array() + epsilon).matrix();
+        const Gradient step = damped.ldlt().solve(current.gradient);
+
+        CCCMechanism candidate = update(result.mechanism, step);
+        Accumulator next = accumulate(candidate, samples, false, threads);
+
+        if (next.squared_error < current.squared_error) {
+            double decrease = current.squared_error - next.squared_error;
+            result.mechanism = candidate;
+            current = accumulate(candidate, samples, true, threads);
+            damping = std::max(damping / 10, 1e-12);
+            if (decrease <= epsilon * epsilon * (1 + current.squared_error) || step.norm() < epsilon * epsilon) {
+                result.state = RefinementState::CONVERGED;
+                break;
+            }
+        } else {
+            damping *= 10;
+            if (step.norm() < epsilon * epsilon) {
+                result.state = RefinementState::CONVERGED;
+                break;
+            }
+            // Levenberg-Marquardt gives up, the error is not decreased by any step
+            if (damping > 1e12) {
+                result.state = RefinementState::STALLED;
+                break;
+            }
+        }
+    }
+
+    result.error = std::sqrt(current.squared_error / static_cast<double>(samples.size()));
+    return result;
+}
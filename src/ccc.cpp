@@ -4,8 +4,137 @@
 
 #include "ccc.h"
 
+#include "precision.h"
+
+#include <limits>
+
 using namespace DualNumberAlgebra;
 
+namespace {
+    /**
+     * \brief Rotation and translation of a frame as plain Eigen types
+     */
+    struct Motion {
+        Eigen::Matrix<double, 3, 3> R;
+        Eigen::Matrix<double, 3, 1> p;
+    };
+
+    /**
+     * \brief Closed-form rodriguez formula for the transformation around a line
+     *
+     * Yields the same as DualFrame(DualSkewProduct(line, phi)) but only the rotation and the translation.
+     */
+    Motion line_motion(const UnitLine &line, const DualNumber &phi) {
+        Eigen::Matrix<double, 3, 1> n = line.n(unchecked).get();
+        Eigen::Matrix<double, 3, 3> k;
+        k << 0, -n(2), n(1),
+             n(2), 0, -n(0),
+             -n(1), n(0), 0;
+        // The anchor closest to the origin
+        Eigen::Matrix<double, 3, 1> a = n.cross(line.m().get());
+
+        Motion motion;
+        motion.R = Eigen::Matrix<double, 3, 3>::Identity() + std::sin(phi.real()) * k + (1 - std::cos(phi.real())) * k * k;
+        motion.p = a - motion.R * a + phi.dual() * n;
+        return motion;
+    }
+
+    /**
+     * \brief Rotation angle error and translation error of a configuration to the pose without the zero posture
+     *
+     * The joint motions are composed as 3x3 rotations and translations.
+     */
+    DualNumber motion_residual(const CCCMechanism &mechanism, const DualFrame &s, const Configuration &config) {
+        auto m1 = line_motion(mechanism.l12, config.phi_1);
+        auto m2 = line_motion(mechanism.l23, config.phi_2);
+        auto m3 = line_motion(mechanism.l34, config.phi_3);
+
+        // Reached S = M1 * M2 * M3
+        Eigen::Matrix<double, 3, 3> r12 = m1.R * m2.R;
+        Eigen::Matrix<double, 3, 3> r = r12 * m3.R;
+        Eigen::Matrix<double, 3, 1> p = m1.p + m1.R * m2.p + r12 * m3.p;
+
+        // Compare with the requested S
+        Eigen::Matrix<double, 3, 3> s_r = s.R().get();
+        Eigen::Matrix<double, 3, 1> s_p = s.p().get();
+
+        // The rotation angle of the difference rotation by an atan2 as it is more stable than acos for small angles
+        Eigen::Matrix<double, 3, 3> e = s_r.transpose() * r;
+        Eigen::Matrix<double, 3, 1> axis(e(2, 1) - e(1, 2), e(0, 2) - e(2, 0), e(1, 0) - e(0, 1));
+        double angle = std::atan2(0.5 * axis.norm(), 0.5 * (e.trace() - 1));
+
+        // The zero posture moves the endeffector away from S and this also changes the positional error
+        Eigen::Matrix<double, 3, 1> z_p = mechanism.zero_posture.p().get();
+        double distance = ((p - s_p) + (r - s_r) * z_p).norm();
+
+        return DualNumber(angle, distance);
+    }
+
+    /**
+     * \brief A line intersecting the given line orthogonally in its canonical anchor
+     */
+    UnitLine orthogonal_line(const UnitLine &line) {
+        Eigen::Matrix<double, 3, 1> n = line.n(unchecked).get();
+        Eigen::Index axis;
+        n.cwiseAbs().minCoeff(&axis);
+        Vector u(n.cross(Eigen::Matrix<double, 3, 1>::Unit(axis)));
+        return UnitLine(UnitDirectionVector(u / u.norm(), unchecked), line.get_canonical_anchor());
+    }
+
+    /**
+     * \brief First order approximation of the twist transforming the current into the requested pose
+     *
+     * The rotation is the vector of the skew part of the rotation matrix.
+     * The translation is the translation of the difference frame.
+     */
+    Eigen::Matrix<double, 6, 1> pose_error(const DualFrame &pose, const DualFrame &current) {
+        auto difference = pose * current.inverse();
+        Eigen::Matrix<double, 3, 3> r = difference.R().get();
+
+        Eigen::Matrix<double, 6, 1> error;
+        error << 0.5 * (r(2, 1) - r(1, 2)),
+                 0.5 * (r(0, 2) - r(2, 0)),
+                 0.5 * (r(1, 0) - r(0, 1)),
+                 difference.p().get();
+        return error;
+    }
+
+    /**
+     * \brief Rotation angle error and translation error between two poses
+     */
+    DualNumber pose_residual(const DualFrame &pose, const DualFrame &current) {
+        Eigen::Matrix<double, 3, 3> e = pose.R().get().transpose() * current.R().get();
+        Eigen::Matrix<double, 3, 1> axis(e(2, 1) - e(1, 2), e(0, 2) - e(2, 0), e(1, 0) - e(0, 1));
+
+        return DualNumber(
+                std::atan2(0.5 * axis.norm(), 0.5 * (e.trace() - 1)),
+                (pose.p() - current.p()).norm());
+    }
+
+    /**
+     * \brief Remove the locked part of a joint value
+     */
+    DualNumber lock(const DualNumber &value, JointType type) {
+        switch (type) {
+            case JointType::REVOLUTE:
+                return DualNumber(value.real(), 0);
+            case JointType::PRISMATIC:
+                return DualNumber(0, value.dual());
+            default:
+                return value;
+        }
+    }
+
+    /**
+     * \brief Replace invalid parts of a joint value by the seed
+     */
+    DualNumber sanitize(const DualNumber &value, const DualNumber &seed) {
+        return DualNumber(
+                std::isfinite(value.real()) ? value.real() : seed.real(),
+                std::isfinite(value.dual()) ? value.dual() : seed.dual());
+    }
+}
+
 CCCMechanism::CCCMechanism(const UnitLine &l12, const UnitLine &l23, const UnitLine &l34, const DualFrame &zero_posture) noexcept
     : l12(l12), l23(l23), l34(l34), zero_posture(zero_posture) {}
 
@@ -18,6 +147,11 @@ CCCMechanism::forward(const Configuration &config) const noexcept {
         this->zero_posture;
 }
 
+void
+CCCMechanism::forward(const Configuration &config, double *pose) const noexcept {
+    this->forward(config).homogeneous(pose);
+}
+
 std::tuple<DualFrame, UnitLine, UnitLine>
 CCCMechanism::forward_verbose(const Configuration &config) const {
     auto fk1 = DualFrame(DualSkewProduct(this->l12, config.phi_1));
@@ -29,104 +163,416 @@ CCCMechanism::forward_verbose(const Configuration &config) const {
 
 std::vector<Configuration>
 CCCMechanism::inverse(const DualFrame &pose) const {
+    auto solutions = this->inverse_lazy(pose);
+    return std::vector<Configuration>(solutions.begin(), solutions.end());
+}
+
+std::vector<Configuration>
+CCCMechanism::inverse(const Eigen::Isometry3d &pose) const {
+    return this->inverse(DualFrame(pose, unchecked));
+}
+
+std::vector<Configuration>
+CCCMechanism::inverse(const double *pose) const {
+    return this->inverse(DualFrame::FromHomogeneous(pose, unchecked));
+}
+
+Eigen::Matrix<double, 6, 6>
+CCCMechanism::jacobian(const Configuration &config) const {
+    auto fk1 = DualFrame(DualSkewProduct(this->l12, config.phi_1));
+    auto fk12 = fk1 * DualFrame(DualSkewProduct(this->l23, config.phi_2));
+
+    // The joint lines in their current position
+    std::array<UnitLine, 3> lines = {this->l12, fk1 * this->l23, fk12 * this->l34};
+
+    Eigen::Matrix<double, 6, 6> jacobian;
+    for (int i = 0; i < 3; i++) {
+        // Rotation around the line
+        jacobian.block<3, 1>(0, 2 * i) = lines[i].n(unchecked).get();
+        jacobian.block<3, 1>(3, 2 * i) = lines[i].m().get();
+        // Translation along the line
+        jacobian.block<3, 1>(0, 2 * i + 1) = Eigen::Matrix<double, 3, 1>::Zero();
+        jacobian.block<3, 1>(3, 2 * i + 1) = lines[i].n(unchecked).get();
+    }
+    return jacobian;
+}
+
+RefinedConfiguration
+CCCMechanism::refine(const DualFrame &pose, const Configuration &seed, unsigned int max_iterations, double tolerance) const {
+    Configuration config = seed;
+    auto current = this->forward(config);
+    auto residual = pose_residual(pose, current);
+
+    unsigned int iteration = 0;
+    while (residual.real() >= tolerance || residual.dual() >= tolerance) {
+        if (iteration == max_iterations) {
+            return {config, residual, RefinementState::MAX_ITERATIONS, iteration};
+        }
+
+        // Gauss-Newton step with the minimal norm for singular configurations
+        Eigen::Matrix<double, 6, 1> step =
+                this->jacobian(config).completeOrthogonalDecomposition().solve(pose_error(pose, current));
+
+        Configuration next = {
+                config.phi_1 + DualNumber(step(0), step(1)),
+                config.phi_2 + DualNumber(step(2), step(3)),
+                config.phi_3 + DualNumber(step(4), step(5))
+        };
+        auto next_current = this->forward(next);
+        auto next_residual = pose_residual(pose, next_current);
+        iteration++;
+
+        if (next_residual.real() + next_residual.dual() >= residual.real() + residual.dual()) {
+            return {config, residual, RefinementState::STALLED, iteration};
+        }
+
+        config = next;
+        current = next_current;
+        residual = next_residual;
+    }
+
+    return {config, residual, RefinementState::CONVERGED, iteration};
+}
+
+std::vector<RefinedConfiguration>
+CCCMechanism::inverse_refined(const DualFrame &pose, const Configuration &seed, unsigned int max_iterations, double tolerance) const {
+    std::vector<RefinedConfiguration> refined;
+    try {
+        auto solutions = this->inverse_lazy(pose);
+        refined.reserve(solutions.size());
+        for (auto solution : solutions) {
+            Configuration sanitized = {
+                    sanitize(solution.phi_1, seed.phi_1),
+                    sanitize(solution.phi_2, seed.phi_2),
+                    sanitize(solution.phi_3, seed.phi_3)
+            };
+            refined.push_back(this->refine(pose, sanitized, max_iterations, tolerance));
+        }
+    } catch(const std::domain_error &) {
+        // No analytic solution. Near the boundary of the workspace the seed still converges.
+        refined.push_back(this->refine(pose, seed, max_iterations, tolerance));
+    }
+    return refined;
+}
+
+std::vector<VerifiedConfiguration>
+CCCMechanism::inverse_verified(const DualFrame &pose) const {
+    auto solutions = this->inverse_lazy(pose);
+
+    std::vector<VerifiedConfiguration> verified;
+    verified.reserve(solutions.size());
+    for (std::size_t i = 0; i < solutions.size(); i++) {
+        verified.push_back(solutions.verified(i));
+    }
+    return verified;
+}
+
+std::vector<Configuration>
+CCCMechanism::inverse(const DualFrame &pose, const std::array<JointType, 3> &types, double tolerance) const {
+    DualFrame s = pose * this->zero_posture.inverse();
+    UnitLine l3f = s * this->l34;
+    LineRelation relation = this->l12.get_relation_to(l3f);
+
+    // The second joint yields the dual angle between the first and the final third line
+    std::array<DualNumber, 3> phi2_solutions;
+    std::size_t count = 0;
+    if (types[1] == JointType::CYLINDRICAL) {
+        // The parallel cases need the extra solutions of the CCC mechanism
+        InverseSolutions lazy(*this, pose);
+        for (; count < lazy.size(); count++) {
+            phi2_solutions[count] = lazy.second_joint(count);
+        }
+    } else {
+        for (const auto &phi_2 : Subproblem::transform_to_distance(
+                this->l23, this->l34, this->l12, this->l12.get_distance(l3f), types[1])) {
+            phi2_solutions[count++] = phi_2;
+        }
+    }
+
+    // Around coinciding lines the first and the third joint share rotation and translation,
+    // along parallel lines only the translation. Anti lines exchange them with the opposite sign.
+    bool coincide = relation == LineRelation::COINCIDE || relation == LineRelation::ANTI_COINCIDE;
+    bool parallel = coincide || relation == LineRelation::PARALLEL || relation == LineRelation::ANTI_PARALLEL;
+    double sign = (relation == LineRelation::ANTI_COINCIDE || relation == LineRelation::ANTI_PARALLEL) ? -1 : 1;
+
+    UnitLine o1 = orthogonal_line(this->l12);
+    UnitLine o3 = orthogonal_line(this->l34);
+
+    std::vector<Configuration> solutions;
+    for (std::size_t i = 0; i < count; i++) {
+        const auto &phi_2 = phi2_solutions[i];
+        if (!std::isfinite(phi_2.dual())) {
+            continue;
+        }
+        DualFrame m2(DualSkewProduct(this->l23, phi_2));
+
+        DualNumber phi_1;
+        if (coincide) {
+            // The whole motion around the first line, the locked part is left to the third joint
+            phi_1 = lock(Subproblem::transform_onto(this->l12, m2 * o1, s * o1, JointType::CYLINDRICAL), types[0]);
+        } else {
+            phi_1 = Subproblem::transform_onto(this->l12, m2 * this->l34, l3f, types[0]);
+        }
+
+        // The third joint performs the remaining motion
+        DualFrame remaining = (DualFrame(DualSkewProduct(this->l12, phi_1)) * m2).inverse() * s;
+        DualNumber phi_3 = Subproblem::transform_onto(this->l34, o3, remaining * o3, JointType::CYLINDRICAL);
+
+        // Hand the locked part of the third joint over to the first joint if they can exchange it
+        if (coincide && types[2] == JointType::PRISMATIC && types[0] != JointType::PRISMATIC) {
+            phi_1 += sign * phi_3.real();
+        }
+        if (parallel && types[2] == JointType::REVOLUTE && types[0] != JointType::REVOLUTE) {
+            phi_1 += DualNumber(0, sign * phi_3.dual());
+        }
+        phi_3 = lock(phi_3, types[2]);
+
+        Configuration solution = {phi_1, phi_2, phi_3};
+        auto residual = motion_residual(*this, s, solution);
+        if (residual.real() <= tolerance && residual.dual() <= tolerance) {
+            solutions.push_back(solution);
+        }
+    }
+    return solutions;
+}
+
+std::vector<Configuration>
+CCCMechanism::inverse_orientation(const RotationMatrix &orientation) const {
+    PointVector origin(0, 0, 0);
+    CCCMechanism wrist(
+            UnitLine(this->l12.n().normal(), origin),
+            UnitLine(this->l23.n().normal(), origin),
+            UnitLine(this->l34.n().normal(), origin),
+            DualFrame(this->zero_posture.R(), origin));
+
+    auto solutions = wrist.inverse(DualFrame(orientation, origin));
+    for (auto &solution : solutions) {
+        // The dual parts are zero up to numerical noise
+        solution.phi_1 = solution.phi_1.real();
+        solution.phi_2 = solution.phi_2.real();
+        solution.phi_3 = solution.phi_3.real();
+    }
+    return solutions;
+}
+
+InverseSolutions
+CCCMechanism::inverse_lazy(const DualFrame &pose) const {
+    return InverseSolutions(*this, pose);
+}
+
+InverseSolutions
+CCCMechanism::inverse_lazy(const DualFrame &pose, std::nothrow_t) const noexcept {
+    return InverseSolutions(*this, pose, std::nothrow);
+}
+
+std::size_t
+CCCMechanism::inverse(const DualFrame &pose, std::array<Configuration, 3> &solutions) const noexcept {
+    InverseSolutions lazy(*this, pose, std::nothrow);
+    for (std::size_t i = 0; i < lazy.size(); i++) {
+        solutions[i] = lazy[i];
+    }
+    return lazy.size();
+}
+
+InverseSolutions::InverseSolutions(const CCCMechanism &mechanism, const DualFrame &pose)
+    : InverseSolutions(mechanism, pose, std::nothrow) {
+    if (this->count == 0) {
+        throw std::domain_error("No solution possible");
+    }
+}
+
+InverseSolutions::InverseSolutions(const CCCMechanism &mechanism, const DualFrame &pose, std::nothrow_t) noexcept
+    : mechanism(&mechanism), pose(pose),
     // Reformulate the pose with the zero posture such that
     // S = M1 * M2 * M3
     // instead of
     // pose = M1 * M2 * M3 * zero_posture
-    auto s = pose * this->zero_posture.inverse();
+      s(pose * mechanism.zero_posture.inverse()),
+      parallelity(LineRelation::SKEW),
+      count(0) {
+    const auto &l12 = mechanism.l12;
+    const auto &l23 = mechanism.l23;
+    const auto &l34 = mechanism.l34;
 
-    // Calculate the projections used for the generalized rodriguez formula
-    DualSkew crossterm(this->l23);
-    DualEmbeddedMatrix uniterm = - crossterm * crossterm;
-    DualEmbeddedMatrix squareterm = DualEmbeddedMatrix(1) - uniterm;
+    // The final position of the third line
+    UnitLine l3f = this->s * l34;
 
     // Calculate parameters regarding the rodriguez formula
-    DualNumber a = this->l12 * (uniterm * this->l34);
-    DualNumber b = this->l12 * (crossterm * this->l34);
-    DualNumber c = this->l12 * ((s - squareterm) * this->l34); // TODO simplify
+    // The projections of the generalized rodriguez formula are not build as embedded matrices.
+    // For a unit line l as dual vector the dual skew is the dual cross product and thus
+    //   uniterm * q = q - (l * q) l
+    //   squareterm * q = (l * q) l
+    // which leaves only dual dot and triple products.
+    DualNumber projection = (l23 * l34) * (l12 * l23);
+    DualNumber a = l12 * l34 - projection;
+    DualNumber b = l12.triple(l23, l34);
+    DualNumber c = l12 * l3f - projection;
 
     // Calculate phi_2 as the trigonometric solutions of a cos + b sin = c
-    std::vector<DualNumber> phi2_solutions = solve_trigonometric_equation(a, b, c);
+    std::array<DualNumber, 2> trigonometric_solutions;
+    this->count = solve_trigonometric_equation(a, b, c, trigonometric_solutions);
+    std::copy(trigonometric_solutions.begin(), trigonometric_solutions.begin() + this->count, this->phi2_solutions.begin());
 
     // Check the line relation between Line 1 and the final Line 3
     // This will result in annoying special cases
-    LineRelation parallelity = this->l12.get_relation_to(s * this->l34);
+    this->parallelity = l12.get_relation_to(l3f);
 
     // Premodifier
     // As we are manipulating phi2_solutions, we use classical array access instead of nice fancy for-ranges :(
     // Maybe not the best way... TODO improve?
-    for (int i = 0; i < phi2_solutions.size(); i++) {
+    for (std::size_t i = 0; i < this->count; i++) {
         // 180° rotations have to be considered separately
-        if (parallelity == LineRelation::ANTI_COINCIDE || parallelity== LineRelation::ANTI_PARALLEL) {
-            phi2_solutions[i] +=  M_PI;
+        if (this->parallelity == LineRelation::ANTI_COINCIDE || this->parallelity == LineRelation::ANTI_PARALLEL) {
+            this->phi2_solutions[i] +=  M_PI;
         }
 
         // atan2 with a solution of primal zero is not solveable right now
         // This happens in parallel cases and thus needs extra care
-        if (parallelity == LineRelation::PARALLEL || parallelity== LineRelation::ANTI_PARALLEL) {
-            DualFrame pre_rot(DualSkewProduct(this->l23, phi2_solutions[i].real()));
-            auto l3i = pre_rot * this->l34;
-            auto l3f = s * this->l34;
+        if (this->parallelity == LineRelation::PARALLEL || this->parallelity == LineRelation::ANTI_PARALLEL) {
+            DualFrame pre_rot(DualSkewProduct(l23, this->phi2_solutions[i].real()));
+            auto l3i = pre_rot * l34;
 
-            double tri_b = abs(this->l12.get_distance(l3i).dual());
-            double tri_c = abs(this->l12.get_distance(l3f).dual());
+            double tri_b = abs(l12.get_distance(l3i).dual());
+            double tri_c = abs(l12.get_distance(l3f).dual());
 
             // Here can actually be seen that to the first atan2 a second pure dual atan2 will be added/substracted
             // The "length" has to be the  dual part of the atan2 solution which cannot be retrieved.
-            double p_2 = phi2_solutions[i].dual();
-            double length = sqrt(p_2 * p_2 - tri_b * tri_b + tri_c * tri_c);
+            double p_2 = this->phi2_solutions[i].dual();
+            // For a double solution rounding may push the radicand slightly below zero
+            double radicand = p_2 * p_2 - tri_b * tri_b + tri_c * tri_c;
+            double length = (radicand < 0 && Compare::is_zero(radicand)) ? 0 : sqrt(radicand);
 
             // Make the actual two solutions of the only one in the parallel case
-            phi2_solutions.push_back(phi2_solutions[i] + DualNumber(0, length));
-            phi2_solutions[i] += DualNumber(0, -length);
+            this->phi2_solutions[this->count] = this->phi2_solutions[i] + DualNumber(0, length);
+            this->phi2_solutions[i] += DualNumber(0, -length);
+            this->count++;
             // Probably needed as the size increases. Not the best solution. It should really be improved...
             break;
         }
     }
+}
 
-    // Container for the solutions
-    std::vector<Configuration> solutions;
-    for (auto phi_2 : phi2_solutions) {
-        // M2 can be calculated already and is the same in all cases
-        DualFrame m2(DualSkewProduct(this->l23, phi_2));
+Configuration
+InverseSolutions::operator[](std::size_t index) const noexcept {
+    const auto &l12 = this->mechanism->l12;
+    const auto &l23 = this->mechanism->l23;
+    const auto &l34 = this->mechanism->l34;
+    const auto &phi_2 = this->phi2_solutions[index];
 
-        // Generic case
-        if (parallelity == LineRelation::SKEW || parallelity == LineRelation::INTERSECT) {
-            // Calculate the angles as the missing transformation around a single line
-            // See paper: "The adjoint trigonometric representation of displacements
-            // and a closed-form solution to the IKP of general 3C chains", Bongardt, ZAMM, 2019
-            auto phi_1 = this->l12.acos3(m2 * this->l34, s * this->l34);
-            auto phi_3 = this->l34.acos3(s.inverse() * this->l12, m2.inverse() * this->l12);
-            solutions.push_back({phi_1, phi_2, phi_3});
+    // A negative radicand in the parallel case yields an invalid solution, which is passed on as NaN
+    if (!std::isfinite(phi_2.dual())) {
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        return {DualNumber(nan, nan), phi_2, DualNumber(nan, nan)};
+    }
 
-        } else {
-            // Coincide
-            if (parallelity == LineRelation::ANTI_COINCIDE || parallelity == LineRelation::COINCIDE) {
-                // Get an orthogonal line to check orientation of the frame
-                // The orthogonality ensures, that it is not the rotation axis
-                DirectionVector u(cross(this->l12.n(), this->l23.n()));
-                UnitLine orthogonal(
-                        u.normal(),
-                        PointVector(0,0,0)
-                );
-
-                // Calculate the angles
-                auto phi_1 = this->l12.acos3(m2 * orthogonal, s * orthogonal);
-                // phi_3 is totally redundant as it gives the transformation of the coinciding line
-                auto phi_3 = DualNumber();
-                solutions.push_back({phi_1, phi_2, phi_3});
-
-            // Parallel
-            } else {
-                auto phi_1 = this->l12.acos3(m2 * this->l34, s * this->l34);
-                auto phi_3 = this->l34.acos3(s.inverse() * this->l12, m2.inverse() * this->l12);
-
-                DualFrame pseudo_pose = this->forward({phi_1, phi_2, phi_3});
-                auto d = (pose.p() - pseudo_pose.p()) * this->l12.n();
-                solutions.push_back({phi_1 + DualNumber(0,d), phi_2, phi_3});
-            }
+    // M2 can be calculated already and is the same in all cases
+    DualFrame m2(DualSkewProduct(l23, phi_2));
+
+    // Generic case
+    if (this->parallelity == LineRelation::SKEW || this->parallelity == LineRelation::INTERSECT) {
+        // Calculate the angles as the missing transformation around a single line
+        // See paper: "The adjoint trigonometric representation of displacements
+        // and a closed-form solution to the IKP of general 3C chains", Bongardt, ZAMM, 2019
+        auto phi_1 = l12.acos3(m2 * l34, this->s * l34);
+        auto phi_3 = l34.acos3(this->s.inverse() * l12, m2.inverse() * l12);
+        return {phi_1, phi_2, phi_3};
+    }
+
+    // Coincide
+    if (this->parallelity == LineRelation::ANTI_COINCIDE || this->parallelity == LineRelation::COINCIDE) {
+        // Get an orthogonal line to check orientation of the frame
+        // The orthogonality ensures, that it is not the rotation axis
+        Vector u = cross(l12.n(), l23.n());
+        if (u.is_zero()) {
+            // Parallel first and second line, any direction orthogonal to the first line works
+            Eigen::Matrix<double, 3, 1> n = l12.n(unchecked).get();
+            Eigen::Index axis;
+            n.cwiseAbs().minCoeff(&axis);
+            u = cross(l12.n(), Vector(Eigen::Matrix<double, 3, 1>::Unit(axis)));
         }
+        UnitLine orthogonal(
+                UnitDirectionVector(u / u.norm(), unchecked),
+                PointVector(0,0,0)
+        );
+
+        // Calculate the angles
+        auto phi_1 = l12.acos3(m2 * orthogonal, this->s * orthogonal);
+        // phi_3 is totally redundant as it gives the transformation of the coinciding line
+        auto phi_3 = DualNumber();
+        return {phi_1, phi_2, phi_3};
     }
 
-    return solutions;
+    // Parallel
+    auto phi_1 = l12.acos3(m2 * l34, this->s * l34);
+    auto phi_3 = l34.acos3(this->s.inverse() * l12, m2.inverse() * l12);
+
+    DualFrame pseudo_pose = this->mechanism->forward({phi_1, phi_2, phi_3});
+    auto d = (this->pose.p() - pseudo_pose.p()) * l12.n();
+    return {phi_1 + DualNumber(0,d), phi_2, phi_3};
+}
+
+VerifiedConfiguration
+InverseSolutions::verified(std::size_t index) const {
+    return this->verify((*this)[index]);
+}
+
+DualNumber
+InverseSolutions::second_joint(std::size_t index) const noexcept {
+    return this->phi2_solutions[index];
+}
+
+VerifiedConfiguration
+InverseSolutions::verify(const Configuration &config) const {
+    return {config, motion_residual(*this->mechanism, this->s, config)};
+}
+
+std::size_t
+InverseSolutions::size() const noexcept {
+    return this->count;
+}
+
+bool
+InverseSolutions::empty() const noexcept {
+    return this->count == 0;
+}
+
+InverseSolutions::iterator
+InverseSolutions::begin() const noexcept {
+    return iterator(this, 0);
+}
+
+InverseSolutions::iterator
+InverseSolutions::end() const noexcept {
+    return iterator(this, this->count);
+}
+
+InverseSolutions::iterator::iterator(const InverseSolutions *solutions, std::size_t index) noexcept
+    : solutions(solutions), index(index) {}
+
+Configuration
+InverseSolutions::iterator::operator*() const noexcept {
+    return (*this->solutions)[this->index];
+}
+
+InverseSolutions::iterator &
+InverseSolutions::iterator::operator++() noexcept {
+    this->index++;
+    return *this;
+}
+
+InverseSolutions::iterator
+InverseSolutions::iterator::operator++(int) noexcept {
+    auto copy = *this;
+    this->index++;
+    return copy;
+}
+
+bool
+InverseSolutions::iterator::operator==(const InverseSolutions::iterator &rhs) const noexcept {
+    return this->solutions == rhs.solutions && this->index == rhs.index;
+}
+
+bool
+InverseSolutions::iterator::operator!=(const InverseSolutions::iterator &rhs) const noexcept {
+    return !(*this == rhs);
 }
@@ -5,59 +5,157 @@
 #include "dual_frame.h"
 
 #include "precision.h"
+#include "../util/parallel.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <limits>
 
-DualFrame::DualFrame(const Mat6 &mat) noexcept: DualEmbeddedMatrix(mat) {}
+namespace {
+    /**
+     * \brief Apply R x + t blockwise, so the result may alias the input
+     */
+    void affine_columns(const Eigen::Matrix<double, 3, 3> &R, const Eigen::Matrix<double, 3, 1> &t,
+                        const Eigen::Ref<const PointBuffer> &input, Eigen::Ref<PointBuffer> result,
+                        Eigen::Index start, Eigen::Index width) {
+        constexpr Eigen::Index block = 64;
+        Eigen::Matrix<double, 3, block> transformed;
+        for (Eigen::Index end = start + width; start < end; start += block) {
+            Eigen::Index size = std::min(block, end - start);
+            transformed.leftCols(size).noalias() = R * input.middleCols(start, size);
+            transformed.leftCols(size).colwise() += t;
+            result.middleCols(start, size) = transformed.leftCols(size);
+        }
+    }
+}
 
 DualFrame::DualFrame(const RotationMatrix &rot, const PointVector &trans) noexcept:
-    DualEmbeddedMatrix(rot, SkewMatrix(trans) * rot) {}
+    rotation(rot), translation(trans) {}
+
+DualFrame::DualFrame(const Eigen::Isometry3d &pose):
+    rotation(RotationMatrix::RotationFromEigen(pose.linear())), translation(Vector(pose.translation())) {}
+
+DualFrame::DualFrame(const Eigen::Isometry3d &pose, Unchecked) noexcept:
+    rotation(pose.linear()), translation(Vector(pose.translation())) {}
+
+DualFrame::DualFrame(const Eigen::Quaterniond &rotation, const Eigen::Vector3d &translation) noexcept:
+    rotation(rotation.normalized().toRotationMatrix()), translation(Vector(translation)) {}
+
+DualFrame DualFrame::FromHomogeneous(const Eigen::Matrix4d &pose) {
+    return {RotationMatrix::RotationFromEigen(pose.topLeftCorner<3, 3>()), PointVector(Vector(pose.topRightCorner<3, 1>()))};
+}
+
+DualFrame DualFrame::FromHomogeneous(const double *pose, Unchecked) noexcept {
+    Eigen::Map<const Eigen::Matrix<double, 3, 4, Eigen::RowMajor>> upper(pose);
+    return {RotationMatrix(upper.leftCols<3>()), PointVector(Vector(upper.col(3)))};
+}
+
+Eigen::Matrix4d DualFrame::homogeneous() const noexcept {
+    Eigen::Matrix4d pose = Eigen::Matrix4d::Identity();
+    pose.topLeftCorner<3, 3>() = this->rotation.get();
+    pose.topRightCorner<3, 1>() = this->translation.get();
+    return pose;
+}
+
+void DualFrame::homogeneous(double *pose) const noexcept {
+    Eigen::Map<Eigen::Matrix<double, 4, 4, Eigen::RowMajor>> target(pose);
+    target.topLeftCorner<3, 3>() = this->rotation.get();
+    target.topRightCorner<3, 1>() = this->translation.get();
+    target.row(3) << 0, 0, 0, 1;
+}
+
+Eigen::Isometry3d DualFrame::isometry() const noexcept {
+    Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+    pose.linear() = this->rotation.get();
+    pose.translation() = this->translation.get();
+    return pose;
+}
+
+DualFrame::DualFrame(const DualSkewProduct &argument) noexcept:
+    rotation(RotationMatrix::Mat3::Identity()), translation(0, 0, 0) {
+    // The skew contains the skew direction and the skew moment, so they are read back directly
+    auto skew = argument.skew().get();
+    Eigen::Matrix<double, 3, 3> k = skew.topLeftCorner(3, 3);
+    Eigen::Matrix<double, 3, 1> n(k(2, 1), k(0, 2), k(1, 0));
+    Eigen::Matrix<double, 3, 1> m(skew(5, 1), skew(3, 2), skew(4, 0));
 
-DualFrame::DualFrame(const DualSkewProduct &argument) noexcept: DualEmbeddedMatrix(argument.skew()) {
-    auto orthoterm = argument.skew();
-    auto uniterm = - orthoterm * orthoterm;
-    auto nullterm = DualEmbeddedMatrix(1.0) - uniterm;
     auto angle = argument.angle();
+    double s = std::sin(angle.real());
+    // 1 - cos is evaluated as 2 sin^2(angle/2), which does not cancel for small angles
+    double half = std::sin(angle.real() / 2);
+    double versine = 2 * half * half;
+
+    // Closed-form rodriguez formula of the rotation
+    Eigen::Matrix<double, 3, 3> R = Eigen::Matrix<double, 3, 3>::Identity() + s * k + versine * k * k;
+    // The rotation moves the canonical anchor and the translation moves along the line
+    // a - R a is expanded, as the anchor of a twist with a small angle is far away and R a would cancel with a
+    Eigen::Matrix<double, 3, 1> a = n.cross(m);
+    Eigen::Matrix<double, 3, 1> ka = k * a;
+    Eigen::Matrix<double, 3, 1> p = -s * ka - versine * (k * ka) + angle.dual() * n;
 
-    this->data = (DualEmbeddedMatrix(cos(angle)) * uniterm +
-                           DualEmbeddedMatrix(sin(angle)) * orthoterm +
-                           nullterm).get();
+    this->rotation = RotationMatrix(R);
+    this->translation = PointVector(Vector(p));
 }
 
 DualFrame DualFrame::operator*(const DualFrame &rhs) const noexcept {
-    return DualFrame(this->data * rhs.data);
+    return {
+        this->rotation * rhs.rotation,
+        PointVector(Vector(this->rotation.data * rhs.translation.get() + this->translation.get()))
+    };
 }
 
 DualFrame DualFrame::inverse() const noexcept {
-    Eigen::Matrix<double, 3,3> rot = this->R().get().transpose();
-    Eigen::Matrix<double, 3,3> dual = this->pxR().get().transpose();
+    auto rot = this->rotation.inverse();
+    return {rot, PointVector(Vector(-(rot.data * this->translation.get())))};
+}
 
-    Mat6 data;
-    data.topLeftCorner(3, 3)     = rot;
-    data.topRightCorner(3, 3)     = Eigen::Matrix<double,3,3>::Zero(3, 3);
-    data.bottomLeftCorner(3, 3)     = dual;
-    data.bottomRightCorner(3, 3)     = rot;
+const RotationMatrix &DualFrame::R() const noexcept {
+    return this->rotation;
+}
 
-    return DualFrame(data);
+Matrix3 DualFrame::pxR() const noexcept {
+    return SkewMatrix(this->translation) * this->rotation;
 }
 
-RotationMatrix DualFrame::R() const noexcept {
-    return RotationMatrix(this->data.topLeftCorner(3,3));
+const PointVector &DualFrame::p() const noexcept {
+    return this->translation;
 }
 
-Matrix3 DualFrame::pxR() const noexcept {
-    return Matrix3(this->data.bottomLeftCorner(3,3));
+DualEmbeddedMatrix DualFrame::embedded() const noexcept {
+    return {this->rotation, this->pxR()};
+}
+
+DualFrame::operator DualEmbeddedMatrix() const noexcept {
+    return this->embedded();
 }
 
-PointVector DualFrame::p() const noexcept {
-    return PointVector(Vector(SkewMatrix(this->pxR() * this->R().inverse())));
+DualEmbeddedMatrix::Mat6 DualFrame::get() const noexcept {
+    return this->embedded().get();
+}
+
+DualEmbeddedMatrix DualFrame::operator-() const noexcept {
+    return -this->embedded();
+}
+
+DualEmbeddedMatrix DualFrame::operator+(const DualEmbeddedMatrix &rhs) const noexcept {
+    return this->embedded() + rhs;
+}
+
+DualEmbeddedMatrix DualFrame::operator-(const DualEmbeddedMatrix &rhs) const noexcept {
+    return this->embedded() - rhs;
+}
+
+DualEmbeddedMatrix DualFrame::operator*(const DualEmbeddedMatrix &rhs) const noexcept {
+    return this->embedded() * rhs;
+}
+
+Screw operator*(const DualFrame &lhs, const Screw &rhs) noexcept {
+    return rhs.Ad(lhs);
 }
 
 std::ostream &operator<<(std::ostream &stream, const DualFrame &d) {
-    auto R = d.data.topLeftCorner(3,3);
-    auto ps = d.data.bottomLeftCorner(3,3) * R.inverse();
-    Eigen::Matrix<double,3,1> p;
-    p << ps(2,1), ps(0,2), ps(1,0);
+    const auto &R = d.rotation.get();
+    const auto &p = d.translation.get();
     stream << std::fixed;
     stream << "┌─────────────────────────────────┬───────────┐" << std::endl;
     for( int i = 0; i < 3; i++) {
@@ -77,26 +175,107 @@ bool operator==(const DualFrame &lhs, const DualFrame &rhs) noexcept {
     if ( ! (check_R< Compare::instance().get_precision()).all() ) {
         return false;
     }
-    auto check_pxR = (lhs.pxR().get() - rhs.pxR().get()).array().abs();
-    if ( ! (check_pxR< Compare::instance().get_precision()).all() ) {
+    auto check_p = (lhs.p().get() - rhs.p().get()).array().abs();
+    if ( ! (check_p< Compare::instance().get_precision()).all() ) {
         return false;
     }
     return true;
 }
 
 DualSkewProduct DualFrame::constructive_line() const noexcept {
-    auto diff = *this - this->inverse();
-    auto n_skew = diff.get().topLeftCorner(3,3);
-    auto m_skew = diff.get().bottomLeftCorner(3,3);
+    const auto &R = this->rotation.get();
+    const auto &p = this->translation.get();
+
+    // The skew part of R is sin(angle) * [n] and the trace is 1 + 2 cos(angle)
+    Eigen::Matrix<double, 3, 1> w(R(2, 1) - R(1, 2), R(0, 2) - R(2, 0), R(1, 0) - R(0, 1));
+    w *= 0.5;
+    double sin_angle = w.norm();
+    double cos_angle = 0.5 * (R.trace() - 1);
+    double angle = std::atan2(sin_angle, cos_angle);
+
+    // Without a rotation, the frame is a pure translation along a line through the origin
+    if (sin_angle < std::numeric_limits<double>::epsilon() && cos_angle > 0) {
+        double distance = p.norm();
+        if (distance < std::numeric_limits<double>::epsilon()) {
+            return {UnitLine(UnitDirectionVector(0, 0, 1), PointVector(0, 0, 0)), DualNumberAlgebra::DualNumber()};
+        }
+        return {UnitLine(UnitDirectionVector(Vector(p / distance), unchecked), PointVector(0, 0, 0)),
+                DualNumberAlgebra::DualNumber(0, distance)};
+    }
+
+    Eigen::Matrix<double, 3, 1> n;
+    if (cos_angle >= 0) {
+        n = w / sin_angle;
+    } else {
+        // Close to a half turn the skew part vanishes but the symmetric part is (1 - cos) n n^T
+        // The column with the largest diagonal element is the most precise
+        Eigen::Matrix<double, 3, 3> outer = 0.5 * (R + R.transpose()) - cos_angle * Eigen::Matrix<double, 3, 3>::Identity();
+        Eigen::Index column;
+        outer.diagonal().maxCoeff(&column);
+        n = outer.col(column).normalized();
+        // The skew part gives the orientation as far as there is one
+        if (n.dot(w) < 0) {
+            n = -n;
+        }
+    }
+
+    // The translation along the line
+    double translation = n.dot(p);
 
-    auto R = this->data.topLeftCorner(3,3);
-    auto pxR = this->data.bottomLeftCorner(3,3);
+    // The remaining translation is (I - R) a for the anchor a orthogonal to n
+    // Within the orthogonal plane this is inverted by ((1 - cos) I + sin [n]) / (2 - 2 cos)
+    // 1 - cos is computed as 2 sin^2(angle/2) to avoid cancellation for small angles
+    Eigen::Matrix<double, 3, 1> rest = p - translation * n;
+    double half_sin = std::sin(0.5 * angle);
+    double one_minus_cos = 2 * half_sin * half_sin;
+    Eigen::Matrix<double, 3, 1> anchor = 0.5 * rest + 0.5 * std::sin(angle) / one_minus_cos * n.cross(rest);
 
-    auto screw = Screw(
-            DirectionVector(Vector(SkewMatrix(Matrix3(n_skew)))),
-            MomentVector(Vector(SkewMatrix(Matrix3(m_skew)))));
+    return {UnitLine(UnitDirectionVector(Vector(n), unchecked), PointVector(Vector(anchor))),
+            DualNumberAlgebra::DualNumber(angle, translation)};
+}
 
-    auto angle = acos(0.5 * (DualNumberAlgebra::DualNumber(R.trace(), pxR.trace()) - 1));
+void transform_lines(const DualFrame &frame, const Eigen::Ref<const ScrewBuffer> &lines,
+                     Eigen::Ref<ScrewBuffer> result, unsigned int threads) {
+    // A line transforms exactly like a screw, the adjoint is already blockwise
+    parallel_columns(lines.cols(), threads, [&](Eigen::Index start, Eigen::Index width) {
+        Ad(frame, lines.middleCols(start, width), result.middleCols(start, width));
+    });
+}
 
-    return {screw.to_line(), angle};
-}
\ No newline at end of file
+void transform_lines(const DualFrame &frame, const double *lines, double *result, std::size_t count,
+                     unsigned int threads) {
+    auto size = static_cast<Eigen::Index>(count);
+    transform_lines(frame, Eigen::Map<const ScrewBuffer>(lines, 6, size), Eigen::Map<ScrewBuffer>(result, 6, size),
+                    threads);
+}
+
+void transform_points(const DualFrame &frame, const Eigen::Ref<const PointBuffer> &points,
+                      Eigen::Ref<PointBuffer> result, unsigned int threads) {
+    const auto &R = frame.R().get();
+    const auto &p = frame.p().get();
+    parallel_columns(points.cols(), threads, [&](Eigen::Index start, Eigen::Index width) {
+        affine_columns(R, p, points, result, start, width);
+    });
+}
+
+void transform_points(const DualFrame &frame, const double *points, double *result, std::size_t count,
+                      unsigned int threads) {
+    auto size = static_cast<Eigen::Index>(count);
+    transform_points(frame, Eigen::Map<const PointBuffer>(points, 3, size), Eigen::Map<PointBuffer>(result, 3, size),
+                     threads);
+}
+
+void transform_directions(const DualFrame &frame, const Eigen::Ref<const PointBuffer> &directions,
+                          Eigen::Ref<PointBuffer> result, unsigned int threads) {
+    const auto &R = frame.R().get();
+    parallel_columns(directions.cols(), threads, [&](Eigen::Index start, Eigen::Index width) {
+        affine_columns(R, Eigen::Matrix<double, 3, 1>::Zero(), directions, result, start, width);
+    });
+}
+
+void transform_directions(const DualFrame &frame, const double *directions, double *result, std::size_t count,
+                          unsigned int threads) {
+    auto size = static_cast<Eigen::Index>(count);
+    transform_directions(frame, Eigen::Map<const PointBuffer>(directions, 3, size),
+                         Eigen::Map<PointBuffer>(result, 3, size), threads);
+}
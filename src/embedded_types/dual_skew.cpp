@@ -14,21 +14,20 @@ DualSkew::DualSkew(const UnitLine &line) noexcept: DualSkew(SkewMatrix(line.n())
 
 UnitLine
 DualSkew::screw() const noexcept {
+    // The dual skew is always created from a line, so nothing has to be checked again
     return UnitLine(
-        UnitDirectionVector( // check if vector is a unit direction vector
+        UnitDirectionVector(
             Vector( // create vector from skew matrix
-                SkewMatrix( // check if matrix is skew matrix
-                    Matrix3(this->data.topLeftCorner(3,3))
-                )
-            )
+                SkewMatrix(Matrix3(this->data.topLeftCorner(3,3)), unchecked)
+            ),
+            unchecked
         ),
         MomentVector( // make vector a moment vector
             Vector( // create vector from skew matrix
-                SkewMatrix( // check if matrix is skew matrix
-                    Matrix3(this->data.bottomLeftCorner(3,3))
-                )
+                SkewMatrix(Matrix3(this->data.bottomLeftCorner(3,3)), unchecked)
             )
-        )
+        ),
+        unchecked
     );
 }
 
@@ -7,6 +7,7 @@
 #include "screw.h"
 #include "dual_number.h"
 #include "vector.h"
+#include "unit_line.h"
 
 DualSkewProduct::DualSkewProduct(const Screw &screw) noexcept:
     _skew(screw.to_line()), _angle(screw.norm()) {}
@@ -22,21 +23,14 @@ DualNumberAlgebra::DualNumber DualSkewProduct::angle() const noexcept {
 }
 
 DualSkewProduct DualSkewProduct::operator+(const DualSkewProduct &rhs) const noexcept {
-    //Eigen::Matrix<double,6,6> sum = DualEmbeddedMatrix(this->_angle).data * this->_skew.data + DualEmbeddedMatrix(rhs._angle).data * rhs._skew.data;
+    // The lie bracket of the weighted skews is the lie bracket of the screws
+    // The screw of a skew product is its line transformed by its angle
+    auto lhs_screw = this->_skew.screw().transform(this->_angle);
+    auto rhs_screw = rhs._skew.screw().transform(rhs._angle);
 
-    Eigen::Matrix<double, 6,6> weighted_lhs_raw = DualEmbeddedMatrix(this->_angle).get() * this->_skew.get();
-    Eigen::Matrix<double, 6,6> weighted_rhs_raw = DualEmbeddedMatrix(rhs._angle).get() * rhs._skew.get();
-
-    Eigen::Matrix<double, 6,6> sum = weighted_lhs_raw * weighted_rhs_raw - weighted_rhs_raw * weighted_lhs_raw; //Lie Bracket
-
-    // To create type safety, sum will be decomposed into the skews itself and then be rebuild.
-    auto n_skew = SkewMatrix(Matrix3(sum.topLeftCorner(3,3)));
-    auto m_skew = SkewMatrix(Matrix3(sum.bottomLeftCorner(3,3)));
-    // this step is allthough still necessary as DualSkewProduct contains the unit line and thus normalizes the screw
+    // DualSkewProduct contains the unit line and thus normalizes the screw
     // The norm itself is again the dual angle and saved as a second variable
-    auto screw = Screw(DirectionVector(Vector(n_skew)), MomentVector(Vector(m_skew)));
-
-    return {screw};
+    return {lhs_screw.ad(rhs_screw)};
 }
 
 bool operator==(const DualSkewProduct &lhs, const DualSkewProduct &rhs) noexcept {
@@ -0,0 +1,61 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "interpolation.h"
+
+#include <stdexcept>
+
+#include "dual_skew_product.h"
+#include "dual_skew.h"
+#include "unit_line.h"
+
+DualFrame sclerp(const DualFrame &from, const DualFrame &to, double t) noexcept {
+    auto line = (from.inverse() * to).constructive_line();
+    return from * DualFrame(DualSkewProduct(line.skew().screw(), line.angle() * t));
+}
+
+ScrewInterpolator::ScrewInterpolator(const DualFrame &from, const DualFrame &to, unsigned int steps)
+    : ScrewInterpolator(std::vector<DualFrame>{from, to}, steps) {}
+
+ScrewInterpolator::ScrewInterpolator(const std::vector<DualFrame> &keyframes, unsigned int steps)
+    : keyframes(keyframes), steps(steps), segment(0), step(0),
+      current(keyframes.empty() ? DualFrame(RotationMatrix(0, 0, 0), PointVector(0, 0, 0)) : keyframes.front()),
+      increment(current) {
+    if (steps == 0) {
+        throw std::invalid_argument("At least one step is needed");
+    }
+    if (keyframes.size() < 2) {
+        throw std::invalid_argument("At least two key frames are needed");
+    }
+    this->start_segment();
+}
+
+void ScrewInterpolator::start_segment() noexcept {
+    auto line = (this->keyframes[this->segment].inverse() * this->keyframes[this->segment + 1]).constructive_line();
+    this->increment = DualFrame(DualSkewProduct(line.skew().screw(), line.angle() / this->steps));
+    this->current = this->keyframes[this->segment];
+    this->step = 0;
+}
+
+bool ScrewInterpolator::has_next() const noexcept {
+    return this->segment + 1 < this->keyframes.size();
+}
+
+DualFrame ScrewInterpolator::next() noexcept {
+    this->step++;
+
+    if (this->step < this->steps) {
+        // The increment is in the local frame and thus multiplied from the right
+        this->current = this->current * this->increment;
+        return this->current;
+    }
+
+    // End of the segment
+    this->segment++;
+    auto end = this->keyframes[this->segment];
+    if (this->has_next()) {
+        this->start_segment();
+    }
+    return end;
+}
@@ -0,0 +1,85 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "forward_cache.h"
+
+using DualNumberAlgebra::DualNumber;
+
+namespace {
+    bool same(const DualNumber &lhs, const DualNumber &rhs) noexcept {
+        return lhs.real() == rhs.real() && lhs.dual() == rhs.dual();
+    }
+}
+
+ForwardCache::ForwardCache(const CCCMechanism &mechanism, const Configuration &config) noexcept
+    : mechanism(&mechanism),
+      l34_local(mechanism.zero_posture.inverse() * mechanism.l34),
+      config(config),
+      m1(mechanism.zero_posture), m12(mechanism.zero_posture), m12_zero(mechanism.zero_posture),
+      end(mechanism.zero_posture),
+      l23_moved(mechanism.l23), l34_moved(mechanism.l34) {
+    this->recompute(1);
+}
+
+void ForwardCache::recompute(unsigned int joint) noexcept {
+    if (joint <= 1) {
+        this->m1 = DualFrame(DualSkewProduct(this->mechanism->l12, this->config.phi_1));
+        this->l23_moved = this->m1 * this->mechanism->l23;
+    }
+    if (joint <= 2) {
+        this->m12 = this->m1 * DualFrame(DualSkewProduct(this->mechanism->l23, this->config.phi_2));
+        this->m12_zero = this->m12 * this->mechanism->zero_posture;
+        this->l34_moved = this->m12 * this->mechanism->l34;
+    }
+    this->end = this->m12_zero * DualFrame(DualSkewProduct(this->l34_local, this->config.phi_3));
+}
+
+void ForwardCache::set_phi_1(const DualNumber &phi) noexcept {
+    this->config.phi_1 = phi;
+    this->recompute(1);
+}
+
+void ForwardCache::set_phi_2(const DualNumber &phi) noexcept {
+    this->config.phi_2 = phi;
+    this->recompute(2);
+}
+
+void ForwardCache::set_phi_3(const DualNumber &phi) noexcept {
+    this->config.phi_3 = phi;
+    this->recompute(3);
+}
+
+void ForwardCache::update(const Configuration &config) noexcept {
+    unsigned int joint = 4;
+    if (!same(config.phi_3, this->config.phi_3)) {
+        joint = 3;
+    }
+    if (!same(config.phi_2, this->config.phi_2)) {
+        joint = 2;
+    }
+    if (!same(config.phi_1, this->config.phi_1)) {
+        joint = 1;
+    }
+
+    this->config = config;
+    if (joint <= 3) {
+        this->recompute(joint);
+    }
+}
+
+const Configuration &ForwardCache::configuration() const noexcept {
+    return this->config;
+}
+
+const DualFrame &ForwardCache::pose() const noexcept {
+    return this->end;
+}
+
+const UnitLine &ForwardCache::second_line() const noexcept {
+    return this->l23_moved;
+}
+
+const UnitLine &ForwardCache::third_line() const noexcept {
+    return this->l34_moved;
+}
@@ -0,0 +1,75 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "axis_identification.h"
+
+#include <cmath>
+
+#include "line_fitting.h"
+#include "dual_skew_product.h"
+#include "precision.h"
+
+AxisIdentifier::AxisIdentifier(const DualFrame &reference, double minimum_angle) noexcept
+    : reference(reference), minimum_angle(minimum_angle) {}
+
+bool AxisIdentifier::add(const DualFrame &pose) {
+    auto motion = (pose * this->reference.inverse()).constructive_line();
+    double angle = motion.angle().real();
+    if (angle < this->minimum_angle) {
+        return false;
+    }
+
+    UnitLine axis = motion.skew().screw();
+    auto n = axis.n().get();
+    auto m = axis.m().get();
+    this->lines.insert(this->lines.end(), {n(0), n(1), n(2), m(0), m(1), m(2)});
+    this->weights.push_back(1 - std::cos(angle));
+    return true;
+}
+
+std::size_t AxisIdentifier::add(const std::vector<DualFrame> &poses) {
+    this->lines.reserve(this->lines.size() + 6 * poses.size());
+    this->weights.reserve(this->weights.size() + poses.size());
+
+    std::size_t used = 0;
+    for (const auto &pose : poses) {
+        used += this->add(pose) ? 1 : 0;
+    }
+    return used;
+}
+
+std::size_t AxisIdentifier::size() const noexcept {
+    return this->weights.size();
+}
+
+UnitLine AxisIdentifier::fit(double scale, std::size_t iterations) const {
+    const auto count = static_cast<Eigen::Index>(this->weights.size());
+    Eigen::Map<const ScrewBuffer> measured(this->lines.data(), 6, count);
+    Eigen::Map<const Eigen::VectorXd> base(this->weights.data(), count);
+
+    UnitLine axis = average_lines(measured, base);
+
+    // Iteratively reweighted average with Cauchy weights
+    Eigen::VectorXd robust(count);
+    for (std::size_t iteration = 0; std::isfinite(scale) && iteration < iterations; iteration++) {
+        const Eigen::Vector3d n = axis.n().get();
+        const Eigen::Vector3d m = axis.m().get();
+        for (Eigen::Index i = 0; i < count; i++) {
+            // Measured axes may have the opposite orientation
+            double orientation = measured.col(i).head<3>().dot(n) < 0 ? -1.0 : 1.0;
+            double residual = (measured.col(i).head<3>() - orientation * n).squaredNorm() +
+                              (measured.col(i).tail<3>() - orientation * m).squaredNorm();
+            robust(i) = base(i) / (1 + residual / (scale * scale));
+        }
+
+        UnitLine next = average_lines(measured, robust);
+        bool converged = (next.n().get() - n).norm() + (next.m().get() - m).norm() < Compare::instance().get_precision();
+        axis = next;
+        if (converged) {
+            break;
+        }
+    }
+
+    return axis;
+}
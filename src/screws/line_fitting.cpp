@@ -0,0 +1,241 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "line_fitting.h"
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+
+#include "vector.h"
+#include "precision.h"
+#include "../util/parallel.h"
+
+namespace {
+    constexpr Eigen::Index block_size = 256;
+    using Block = Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::ColMajor, 3, block_size>;
+    using Mask = Eigen::Array<bool, 1, Eigen::Dynamic, Eigen::RowMajor, 1, block_size>;
+
+    /**
+     * \brief Points of a block within the threshold of a line given by direction and moment
+     *
+     * The distance is the norm of m - p x n as in UnitLine::get_distance(const PointVector &).
+     */
+    Mask close_to(const Eigen::Vector3d &n, const Eigen::Vector3d &m,
+                  const Eigen::Ref<const PointBuffer> &points, Eigen::Index start, Eigen::Index width,
+                  double squared_threshold) noexcept {
+        const auto p = points.middleCols(start, width).array();
+        const auto rx = m.x() - (p.row(1) * n.z() - p.row(2) * n.y());
+        const auto ry = m.y() - (p.row(2) * n.x() - p.row(0) * n.z());
+        const auto rz = m.z() - (p.row(0) * n.y() - p.row(1) * n.x());
+        return (rx * rx + ry * ry + rz * rz) <= squared_threshold;
+    }
+
+    std::size_t count_close(const Eigen::Vector3d &n, const Eigen::Vector3d &m,
+                            const Eigen::Ref<const PointBuffer> &points, double squared_threshold) noexcept {
+        std::size_t count = 0;
+        for (Eigen::Index start = 0; start < points.cols(); start += block_size) {
+            const Eigen::Index width = std::min(block_size, points.cols() - start);
+            count += close_to(n, m, points, start, width, squared_threshold).count();
+        }
+        return count;
+    }
+}
+
+LineFitter::LineFitter() noexcept : count(0), mean(Eigen::Vector3d::Zero()), scatter(Eigen::Matrix3d::Zero()) {}
+
+void LineFitter::merge(std::size_t other_count, const Eigen::Vector3d &other_mean,
+                       const Eigen::Matrix3d &other_scatter) noexcept {
+    if (other_count == 0) {
+        return;
+    }
+
+    // Parallel variant of the Welford update
+    const double total = static_cast<double>(this->count + other_count);
+    const Eigen::Vector3d delta = other_mean - this->mean;
+    const double weight = static_cast<double>(this->count) * static_cast<double>(other_count) / total;
+
+    this->scatter += other_scatter + weight * delta * delta.transpose();
+    this->mean += delta * (static_cast<double>(other_count) / total);
+    this->count += other_count;
+}
+
+void LineFitter::add(const PointVector &point) noexcept {
+    this->merge(1, point.get(), Eigen::Matrix3d::Zero());
+}
+
+void LineFitter::add(const Eigen::Ref<const PointBuffer> &points, unsigned int threads) {
+    std::mutex mutex;
+    parallel_columns(points.cols(), threads, [&](Eigen::Index start, Eigen::Index width) {
+        LineFitter part;
+        Block centered;
+        for (Eigen::Index block = start; block < start + width; block += block_size) {
+            const Eigen::Index size = std::min(block_size, start + width - block);
+            const Eigen::Vector3d block_mean = points.middleCols(block, size).rowwise().mean();
+            centered = points.middleCols(block, size).colwise() - block_mean;
+            part.merge(static_cast<std::size_t>(size), block_mean, centered * centered.transpose());
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        this->merge(part);
+    });
+}
+
+void LineFitter::merge(const LineFitter &other) noexcept {
+    this->merge(other.count, other.mean, other.scatter);
+}
+
+std::size_t LineFitter::size() const noexcept {
+    return this->count;
+}
+
+PointVector LineFitter::centroid() const {
+    if (this->count == 0) {
+        throw std::domain_error("The centroid of no points is undefined");
+    }
+    return PointVector(Vector(this->mean));
+}
+
+UnitLine LineFitter::fit() const {
+    UnitLine line(UnitDirectionVector(0, 0, 1), PointVector(0, 0, 0));
+    if (!this->fit(line)) {
+        throw std::domain_error("A line cannot be fitted to a single point");
+    }
+    return line;
+}
+
+bool LineFitter::fit(UnitLine &line) const noexcept {
+    // The eigenvalue is a sum of squared distances, so the precision is squared and scaled by the number of points
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(this->scatter);
+    const double precision = Compare::instance().get_precision();
+    if (this->count < 2 || solver.eigenvalues()(2) <= precision * precision * static_cast<double>(this->count)) {
+        return false;
+    }
+
+    // The eigenvalues are sorted increasingly, the last eigenvector has the largest spread
+    line = UnitLine(UnitDirectionVector(Vector(solver.eigenvectors().col(2)), unchecked), PointVector(Vector(this->mean)));
+    return true;
+}
+
+double LineFitter::residual() const noexcept {
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(this->scatter, Eigen::EigenvaluesOnly);
+    return std::max(0.0, solver.eigenvalues()(0) + solver.eigenvalues()(1));
+}
+
+UnitLine average_lines(const Eigen::Ref<const ScrewBuffer> &lines, const Eigen::Ref<const Eigen::VectorXd> &weights) {
+    Eigen::Matrix3d directions = Eigen::Matrix3d::Zero();
+    Eigen::Matrix3d normal = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d anchors = Eigen::Vector3d::Zero();
+    double total = 0;
+    for (Eigen::Index i = 0; i < lines.cols(); i++) {
+        const Eigen::Vector3d n = lines.col(i).head<3>();
+        const Eigen::Matrix3d outer = weights(i) * n * n.transpose();
+        directions += outer;
+        // The squared distance of a point x to the line is x^T (I - n n^T) x - 2 x^T (n x m) + const
+        normal += weights(i) * Eigen::Matrix3d::Identity() - outer;
+        anchors += weights(i) * n.cross(lines.col(i).tail<3>());
+        total += weights(i);
+    }
+    if (!(total > 0)) {
+        throw std::domain_error("The average of no lines is undefined");
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(directions);
+    Eigen::Vector3d n = solver.eigenvectors().col(2);
+    if ((weights.transpose() * (lines.topRows<3>().transpose() * n).array().sign().matrix())(0) < 0) {
+        n = -n;
+    }
+
+    // Equal directions leave the position along the line open, which is fixed by an additional term along n
+    Eigen::Vector3d anchor = (normal + total * n * n.transpose()).ldlt().solve(anchors);
+    return UnitLine(DirectionVector(Vector(n)), PointVector(Vector(anchor)));
+}
+
+std::vector<ExtractedLine> extract_lines(const Eigen::Ref<const PointBuffer> &points, double threshold,
+                                         std::size_t minimum_inliers, std::size_t maximum_lines,
+                                         std::size_t iterations, unsigned int seed) {
+    minimum_inliers = std::max<std::size_t>(minimum_inliers, 2);
+    const double squared_threshold = threshold * threshold;
+    std::mt19937 generator(seed);
+
+    // The remaining points are kept compact together with their original columns
+    PointBuffer remaining = points;
+    std::vector<Eigen::Index> columns(points.cols());
+    for (Eigen::Index i = 0; i < points.cols(); i++) {
+        columns[i] = i;
+    }
+
+    std::vector<ExtractedLine> lines;
+    while (lines.size() < maximum_lines && static_cast<std::size_t>(remaining.cols()) >= minimum_inliers) {
+        std::uniform_int_distribution<Eigen::Index> sample(0, remaining.cols() - 1);
+
+        std::size_t best_count = 0;
+        Eigen::Vector3d best_n;
+        Eigen::Vector3d best_m;
+        for (std::size_t iteration = 0; iteration < iterations; iteration++) {
+            const Eigen::Vector3d p = remaining.col(sample(generator));
+            const Eigen::Vector3d direction = remaining.col(sample(generator)) - p;
+            if (Compare::is_zero(direction.norm())) {
+                continue;
+            }
+            const Eigen::Vector3d n = direction.normalized();
+            const Eigen::Vector3d m = p.cross(n);
+
+            std::size_t count = count_close(n, m, remaining, squared_threshold);
+            if (count > best_count) {
+                best_count = count;
+                best_n = n;
+                best_m = m;
+            }
+        }
+        if (best_count < minimum_inliers) {
+            break;
+        }
+
+        // Refine by a least squares fit to the inliers and collect the inliers of the refined line
+        LineFitter fitter;
+        for (Eigen::Index start = 0; start < remaining.cols(); start += block_size) {
+            const Eigen::Index width = std::min(block_size, remaining.cols() - start);
+            auto close = close_to(best_n, best_m, remaining, start, width, squared_threshold);
+            for (Eigen::Index i = 0; i < width; i++) {
+                if (close(i)) {
+                    fitter.add(PointVector(Vector(remaining.col(start + i))));
+                }
+            }
+        }
+        // Inliers within the precision of each other, e.g. repeated measurements of one point, have no direction.
+        // Such a candidate is skipped, but its inliers are removed, so that it is not found again.
+        ExtractedLine extracted{UnitLine(DirectionVector(Vector(best_n)), PointVector(Vector(best_n.cross(best_m)))), {}};
+        const bool skipped = !fitter.fit(extracted.line);
+        const Eigen::Vector3d n = extracted.line.n().get();
+        const Eigen::Vector3d m = extracted.line.m().get();
+
+        Eigen::Index kept = 0;
+        for (Eigen::Index start = 0; start < remaining.cols(); start += block_size) {
+            const Eigen::Index width = std::min(block_size, remaining.cols() - start);
+            auto close = close_to(n, m, remaining, start, width, squared_threshold);
+            for (Eigen::Index i = 0; i < width; i++) {
+                if (close(i)) {
+                    extracted.inliers.push_back(columns[start + i]);
+                } else {
+                    remaining.col(kept) = remaining.col(start + i);
+                    columns[kept] = columns[start + i];
+                    kept++;
+                }
+            }
+        }
+        if (!skipped && extracted.inliers.size() < minimum_inliers) {
+            break;
+        }
+
+        remaining.conservativeResize(Eigen::NoChange, kept);
+        columns.resize(kept);
+        if (!skipped) {
+            lines.push_back(std::move(extracted));
+        }
+    }
+
+    return lines;
+}
@@ -0,0 +1,273 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "line_index.h"
+
+#include <algorithm>
+#include <queue>
+
+#include "../util/parallel.h"
+
+namespace {
+    /**
+     * \brief Size measure of a box for the insertion heuristic
+     *
+     * The sum of the edge lengths, as boxes of axis aligned segments are flat and have no volume.
+     */
+    double box_cost(const Eigen::AlignedBox3d &box) noexcept {
+        return box.sizes().sum();
+    }
+
+    /**
+     * \brief Lower bound and exact distance for point queries
+     */
+    struct PointQuery {
+        const PointVector &point;
+
+        double bound(const Eigen::AlignedBox3d &box) const noexcept {
+            return box.exteriorDistance(this->point.get());
+        }
+
+        double exact(const LineSegment &segment) const noexcept {
+            return segment.get_distance(this->point);
+        }
+    };
+
+    /**
+     * \brief Lower bound and exact distance for line queries
+     *
+     * The box is bounded by its circumscribed sphere.
+     */
+    struct LineQuery {
+        const UnitLine &line;
+
+        double bound(const Eigen::AlignedBox3d &box) const noexcept {
+            double radius = 0.5 * box.diagonal().norm();
+            double center = this->line.get_distance(PointVector(Vector(box.center())));
+            return std::max(0.0, center - radius);
+        }
+
+        double exact(const LineSegment &segment) const noexcept {
+            return segment.get_distance(this->line);
+        }
+    };
+
+    bool closer(const LineNeighbor &lhs, const LineNeighbor &rhs) noexcept {
+        return lhs.distance < rhs.distance;
+    }
+}
+
+LineIndex::LineIndex() noexcept : root(-1) {}
+
+LineIndex::LineIndex(const std::vector<LineSegment> &segments) : segments(segments), root(-1) {
+    if (segments.empty()) {
+        return;
+    }
+
+    this->nodes.reserve(2 * segments.size());
+    std::vector<int> leaves;
+    leaves.reserve(segments.size());
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        leaves.push_back(this->create_leaf(i));
+    }
+    this->root = this->build(leaves, 0, leaves.size());
+    this->nodes[this->root].parent = -1;
+}
+
+int LineIndex::create_leaf(std::size_t segment) {
+    const auto &s = this->segments[segment];
+    Eigen::AlignedBox3d box(s.start().get());
+    box.extend(s.end().get());
+    this->nodes.push_back({box, -1, -1, -1, segment});
+    return static_cast<int>(this->nodes.size() - 1);
+}
+
+int LineIndex::build(std::vector<int> &leaves, std::size_t begin, std::size_t end) {
+    if (end - begin == 1) {
+        return leaves[begin];
+    }
+
+    // Split at the median of the centers along the axis with the largest spread
+    Eigen::AlignedBox3d centers;
+    for (std::size_t i = begin; i < end; i++) {
+        centers.extend(this->nodes[leaves[i]].box.center());
+    }
+    Eigen::Index axis;
+    centers.sizes().maxCoeff(&axis);
+
+    std::size_t middle = begin + (end - begin) / 2;
+    std::nth_element(leaves.begin() + begin, leaves.begin() + middle, leaves.begin() + end,
+                     [this, axis](int lhs, int rhs) {
+                         return this->nodes[lhs].box.center()(axis) < this->nodes[rhs].box.center()(axis);
+                     });
+
+    int left = this->build(leaves, begin, middle);
+    int right = this->build(leaves, middle, end);
+
+    this->nodes.push_back({this->nodes[left].box.merged(this->nodes[right].box), -1, left, right, 0});
+    int node = static_cast<int>(this->nodes.size() - 1);
+    this->nodes[left].parent = node;
+    this->nodes[right].parent = node;
+    return node;
+}
+
+std::size_t LineIndex::insert(const LineSegment &segment) {
+    this->segments.push_back(segment);
+    std::size_t index = this->segments.size() - 1;
+    int leaf = this->create_leaf(index);
+
+    if (this->root < 0) {
+        this->root = leaf;
+        return index;
+    }
+
+    // Descend to the sibling with the least enlargement
+    const auto box = this->nodes[leaf].box;
+    int sibling = this->root;
+    while (this->nodes[sibling].left >= 0) {
+        const auto &node = this->nodes[sibling];
+        double left = box_cost(this->nodes[node.left].box.merged(box)) - box_cost(this->nodes[node.left].box);
+        double right = box_cost(this->nodes[node.right].box.merged(box)) - box_cost(this->nodes[node.right].box);
+        sibling = left <= right ? node.left : node.right;
+    }
+
+    // Replace the sibling by a new parent of the sibling and the leaf
+    int old_parent = this->nodes[sibling].parent;
+    this->nodes.push_back({this->nodes[sibling].box.merged(box), old_parent, sibling, leaf, 0});
+    int parent = static_cast<int>(this->nodes.size() - 1);
+    this->nodes[sibling].parent = parent;
+    this->nodes[leaf].parent = parent;
+
+    if (old_parent < 0) {
+        this->root = parent;
+    } else {
+        auto &grand_parent = this->nodes[old_parent];
+        (grand_parent.left == sibling ? grand_parent.left : grand_parent.right) = parent;
+    }
+
+    // Refit the boxes up to the root
+    for (int node = old_parent; node >= 0; node = this->nodes[node].parent) {
+        this->nodes[node].box.extend(box);
+    }
+    return index;
+}
+
+std::size_t LineIndex::size() const noexcept {
+    return this->segments.size();
+}
+
+const LineSegment &LineIndex::operator[](std::size_t index) const noexcept {
+    return this->segments[index];
+}
+
+template<typename Query>
+std::vector<LineNeighbor> LineIndex::search_nearest(const Query &query, std::size_t k) const {
+    std::vector<LineNeighbor> found;
+    if (this->root < 0 || k == 0) {
+        return found;
+    }
+
+    // Best first search, the nodes are visited ordered by their lower bound
+    using Candidate = std::pair<double, int>;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    candidates.emplace(query.bound(this->nodes[this->root].box), this->root);
+
+    // found is kept as max heap, so the worst of the k best is at the front
+    while (!candidates.empty()) {
+        auto candidate = candidates.top();
+        candidates.pop();
+        if (found.size() == k && candidate.first >= found.front().distance) {
+            break;
+        }
+
+        const auto &node = this->nodes[candidate.second];
+        if (node.left < 0) {
+            LineNeighbor neighbor = {node.segment, query.exact(this->segments[node.segment])};
+            if (found.size() < k) {
+                found.push_back(neighbor);
+                std::push_heap(found.begin(), found.end(), closer);
+            } else if (neighbor.distance < found.front().distance) {
+                std::pop_heap(found.begin(), found.end(), closer);
+                found.back() = neighbor;
+                std::push_heap(found.begin(), found.end(), closer);
+            }
+            continue;
+        }
+
+        candidates.emplace(query.bound(this->nodes[node.left].box), node.left);
+        candidates.emplace(query.bound(this->nodes[node.right].box), node.right);
+    }
+
+    std::sort_heap(found.begin(), found.end(), closer);
+    return found;
+}
+
+template<typename Query>
+std::vector<LineNeighbor> LineIndex::search_within(const Query &query, double distance) const {
+    std::vector<LineNeighbor> found;
+    if (this->root < 0) {
+        return found;
+    }
+
+    std::vector<int> stack = {this->root};
+    while (!stack.empty()) {
+        const auto &node = this->nodes[stack.back()];
+        stack.pop_back();
+        if (query.bound(node.box) > distance) {
+            continue;
+        }
+
+        if (node.left < 0) {
+            double exact = query.exact(this->segments[node.segment]);
+            if (exact <= distance) {
+                found.push_back({node.segment, exact});
+            }
+            continue;
+        }
+
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+    }
+
+    std::sort(found.begin(), found.end(), closer);
+    return found;
+}
+
+std::vector<LineNeighbor> LineIndex::nearest(const PointVector &point, std::size_t k) const {
+    return this->search_nearest(PointQuery{point}, k);
+}
+
+std::vector<LineNeighbor> LineIndex::nearest(const UnitLine &line, std::size_t k) const {
+    return this->search_nearest(LineQuery{line}, k);
+}
+
+std::vector<LineNeighbor> LineIndex::within(const PointVector &point, double distance) const {
+    return this->search_within(PointQuery{point}, distance);
+}
+
+std::vector<LineNeighbor> LineIndex::within(const UnitLine &line, double distance) const {
+    return this->search_within(LineQuery{line}, distance);
+}
+
+std::vector<std::vector<LineNeighbor>>
+LineIndex::nearest(const std::vector<PointVector> &points, std::size_t k, unsigned int threads) const {
+    std::vector<std::vector<LineNeighbor>> results(points.size());
+    parallel_columns(static_cast<Eigen::Index>(points.size()), threads, [&](Eigen::Index start, Eigen::Index width) {
+        for (Eigen::Index i = start; i < start + width; i++) {
+            results[i] = this->nearest(points[i], k);
+        }
+    }, 64);
+    return results;
+}
+
+std::vector<std::vector<LineNeighbor>>
+LineIndex::nearest(const std::vector<UnitLine> &lines, std::size_t k, unsigned int threads) const {
+    std::vector<std::vector<LineNeighbor>> results(lines.size());
+    parallel_columns(static_cast<Eigen::Index>(lines.size()), threads, [&](Eigen::Index start, Eigen::Index width) {
+        for (Eigen::Index i = start; i < start + width; i++) {
+            results[i] = this->nearest(lines[i], k);
+        }
+    }, 64);
+    return results;
+}
@@ -0,0 +1,132 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "line_registration.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "vector.h"
+#include "matrix3.h"
+#include "precision.h"
+#include "../util/parallel.h"
+
+namespace {
+    /**
+     * \brief Weighted closed form registration
+     * @return False if the directions do not determine the rotation
+     */
+    bool solve(const Eigen::Ref<const ScrewBuffer> &from, const Eigen::Ref<const ScrewBuffer> &to,
+               const Eigen::VectorXd &weights, Eigen::Matrix3d &R, Eigen::Vector3d &p) noexcept {
+        // Rotation by the correlation of the directions
+        Eigen::Matrix3d H = from.topRows<3>() * weights.asDiagonal() * to.topRows<3>().transpose();
+        Eigen::JacobiSVD<Eigen::Matrix3d> svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+        const auto &sigma = svd.singularValues();
+        if (!(sigma(1) > Compare::instance().get_precision() * sigma(0))) {
+            return false;
+        }
+        Eigen::Vector3d reflection(1, 1, (svd.matrixV() * svd.matrixU().transpose()).determinant() > 0 ? 1 : -1);
+        R = svd.matrixV() * reflection.asDiagonal() * svd.matrixU().transpose();
+
+        // Translation by the normal equations of [R n]x p = R m - m'
+        Eigen::Matrix3d A = Eigen::Matrix3d::Zero();
+        Eigen::Vector3d b = Eigen::Vector3d::Zero();
+        for (Eigen::Index i = 0; i < from.cols(); i++) {
+            const Eigen::Vector3d a = R * from.col(i).head<3>();
+            const Eigen::Vector3d rhs = R * from.col(i).tail<3>() - to.col(i).tail<3>();
+            // [a]x^T [a]x = I - a a^T for a unit direction and [a]x^T x = x cross a
+            A += weights(i) * (Eigen::Matrix3d::Identity() - a * a.transpose());
+            b += weights(i) * rhs.cross(a);
+        }
+        p = A.ldlt().solve(b);
+        return true;
+    }
+
+    /**
+     * \brief Residuals of the pluecker coordinates of the transformed and the target lines
+     */
+    void residuals(const Eigen::Ref<const ScrewBuffer> &from, const Eigen::Ref<const ScrewBuffer> &to,
+                   const Eigen::Matrix3d &R, const Eigen::Vector3d &p, Eigen::VectorXd &result) noexcept {
+        for (Eigen::Index i = 0; i < from.cols(); i++) {
+            const Eigen::Vector3d n = R * from.col(i).head<3>();
+            const Eigen::Vector3d m = R * from.col(i).tail<3>() + p.cross(n);
+            result(i) = std::sqrt((n - to.col(i).head<3>()).squaredNorm() + (m - to.col(i).tail<3>()).squaredNorm());
+        }
+    }
+}
+
+DualFrame register_lines(const std::vector<UnitLine> &from, const std::vector<UnitLine> &to) {
+    if (from.size() != to.size()) {
+        throw std::invalid_argument("Each line needs a corresponding line");
+    }
+
+    ScrewBuffer from_buffer(6, from.size());
+    ScrewBuffer to_buffer(6, to.size());
+    for (std::size_t i = 0; i < from.size(); i++) {
+        from_buffer.col(i) << from[i].n().get(), from[i].m().get();
+        to_buffer.col(i) << to[i].n().get(), to[i].m().get();
+    }
+
+    auto registration = register_lines(from_buffer, to_buffer);
+    if (!registration.valid) {
+        throw std::domain_error("Parallel lines do not determine a frame");
+    }
+    return registration.frame;
+}
+
+Registration register_lines(const Eigen::Ref<const ScrewBuffer> &from, const Eigen::Ref<const ScrewBuffer> &to,
+                            double scale, std::size_t iterations) noexcept {
+    Registration registration{DualFrame(RotationMatrix(0, 0, 0), PointVector(0, 0, 0)), 0, false};
+    if (from.cols() != to.cols() || from.cols() < 2) {
+        return registration;
+    }
+
+    Eigen::VectorXd weights = Eigen::VectorXd::Ones(from.cols());
+    Eigen::VectorXd errors(from.cols());
+    Eigen::Matrix3d R;
+    Eigen::Vector3d p;
+    if (!solve(from, to, weights, R, p)) {
+        return registration;
+    }
+    residuals(from, to, R, p, errors);
+
+    // Iteratively reweighted least squares with Cauchy weights
+    for (std::size_t iteration = 0; std::isfinite(scale) && iteration < iterations; iteration++) {
+        weights = (1 + (errors / scale).array().square()).inverse().matrix();
+
+        Eigen::Matrix3d next_R;
+        Eigen::Vector3d next_p;
+        if (!solve(from, to, weights, next_R, next_p)) {
+            break;
+        }
+        bool converged = (next_R - R).norm() + (next_p - p).norm() < Compare::instance().get_precision();
+        R = next_R;
+        p = next_p;
+        residuals(from, to, R, p, errors);
+        if (converged) {
+            break;
+        }
+    }
+
+    registration.frame = DualFrame(RotationMatrix::RotationFromEigen(R, unchecked), PointVector(Vector(p)));
+    registration.error = std::sqrt(weights.dot(errors.cwiseAbs2()) / weights.sum());
+    registration.valid = true;
+    return registration;
+}
+
+std::vector<Registration> register_lines(const std::vector<ScrewBuffer> &from, const std::vector<ScrewBuffer> &to,
+                                         double scale, std::size_t iterations, unsigned int threads) {
+    if (from.size() != to.size()) {
+        throw std::invalid_argument("Each line set needs a corresponding line set");
+    }
+
+    std::vector<Registration> registrations(
+            from.size(), {DualFrame(RotationMatrix(0, 0, 0), PointVector(0, 0, 0)), 0, false});
+    parallel_columns(static_cast<Eigen::Index>(from.size()), threads, [&](Eigen::Index start, Eigen::Index width) {
+        for (Eigen::Index i = start; i < start + width; i++) {
+            registrations[i] = register_lines(from[i], to[i], scale, iterations);
+        }
+    }, 1);
+    return registrations;
+}
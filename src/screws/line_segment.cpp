@@ -0,0 +1,184 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "line_segment.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "precision.h"
+
+LineSegment::LineSegment(const PointVector &start, const PointVector &end)
+    : carrier(start, end), first(start), second(end), extent((end - start).norm()) {}
+
+LineSegment::LineSegment(const UnitLine &line, double from, double to)
+    : carrier(line),
+      first(Vector(line.get_canonical_anchor() + line.n() * from)),
+      second(Vector(line.get_canonical_anchor() + line.n() * to)),
+      extent(to - from) {
+    if (!(to > from)) {
+        throw std::invalid_argument("The end of the segment has to be behind its start");
+    }
+}
+
+const UnitLine &LineSegment::line() const noexcept {
+    return this->carrier;
+}
+
+const PointVector &LineSegment::start() const noexcept {
+    return this->first;
+}
+
+const PointVector &LineSegment::end() const noexcept {
+    return this->second;
+}
+
+double LineSegment::length() const noexcept {
+    return this->extent;
+}
+
+namespace {
+    PointVector clamp_to(const LineSegment &segment, const PointVector &projection) noexcept {
+        double t = segment.line().n() * (projection - segment.start());
+        t = std::min(std::max(t, 0.0), segment.length());
+        return PointVector(segment.start() + segment.line().n() * t);
+    }
+}
+
+PointVector LineSegment::closest_point(const PointVector &p) const noexcept {
+    return clamp_to(*this, this->carrier.point_project(p));
+}
+
+PointVector LineSegment::closest_point(const UnitLine &l) const noexcept {
+    return clamp_to(*this, this->carrier.point_project(l));
+}
+
+double LineSegment::get_distance(const PointVector &p) const noexcept {
+    return (p - this->closest_point(p)).norm();
+}
+
+double LineSegment::get_distance(const UnitLine &l) const noexcept {
+    return l.get_distance(this->closest_point(l));
+}
+
+std::pair<PointVector, PointVector> LineSegment::closest_points(const LineSegment &s) const noexcept {
+    // For parallel lines point_project yields the anchor, the back and forth projection finds the closest ends
+    PointVector p = clamp_to(*this, this->carrier.point_project(s.carrier));
+    PointVector q = s.closest_point(p);
+    p = this->closest_point(q);
+    return std::make_pair(p, q);
+}
+
+double LineSegment::get_distance(const LineSegment &s) const noexcept {
+    auto points = this->closest_points(s);
+    return (points.first - points.second).norm();
+}
+
+Capsule::Capsule(const LineSegment &axis, double radius) : segment(axis), size(radius) {
+    if (radius < 0) {
+        throw std::invalid_argument("The radius of a capsule must not be negative");
+    }
+}
+
+const LineSegment &Capsule::axis() const noexcept {
+    return this->segment;
+}
+
+double Capsule::radius() const noexcept {
+    return this->size;
+}
+
+double Capsule::get_distance(const Capsule &c) const noexcept {
+    return this->segment.get_distance(c.segment) - this->size - c.size;
+}
+
+bool Capsule::collides(const Capsule &c) const noexcept {
+    return this->get_distance(c) <= 0;
+}
+
+namespace {
+    constexpr Eigen::Index lane_width = 64;
+    using Lane = Eigen::Array<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, lane_width>;
+
+    /**
+     * \brief Segment distances of one segment against blocks of segments
+     *
+     * The same clamping as LineSegment::closest_points written with dot products,
+     *   so that a whole block of the second buffer is handled by array operations on the stack.
+     */
+    template<typename RadiusA, typename RadiusB>
+    SegmentPair closest_pair_kernel(const Eigen::Ref<const SegmentBuffer> &a, const RadiusA &radius_a,
+                                    const Eigen::Ref<const SegmentBuffer> &b, const RadiusB &radius_b,
+                                    double threshold) noexcept {
+        SegmentPair best;
+        const double epsilon = Compare::instance().get_precision();
+
+        for (Eigen::Index i = 0; i < a.cols(); i++) {
+            const Eigen::Vector3d p1 = a.col(i).head<3>();
+            const Eigen::Vector3d d1 = a.col(i).tail<3>() - p1;
+            const double aa = d1.squaredNorm();
+
+            for (Eigen::Index start = 0; start < b.cols(); start += lane_width) {
+                const Eigen::Index width = std::min(lane_width, b.cols() - start);
+                const auto block = b.middleCols(start, width).array();
+
+                Lane d2x = block.row(3) - block.row(0);
+                Lane d2y = block.row(4) - block.row(1);
+                Lane d2z = block.row(5) - block.row(2);
+                Lane rx = p1.x() - block.row(0);
+                Lane ry = p1.y() - block.row(1);
+                Lane rz = p1.z() - block.row(2);
+
+                Lane e = d2x * d2x + d2y * d2y + d2z * d2z;
+                Lane f = d2x * rx + d2y * ry + d2z * rz;
+                Lane c = d1.x() * rx + d1.y() * ry + d1.z() * rz;
+                Lane bb = d1.x() * d2x + d1.y() * d2y + d1.z() * d2z;
+                Lane denominator = aa * e - bb * bb;
+
+                // Closest point of the lines on the first segment, the start for parallel lines
+                Lane s = (denominator > epsilon * aa * e)
+                        .select(((bb * f - c * e) / denominator).max(0.0).min(1.0), Lane::Zero(width));
+                // Project onto the second segment and back onto the first one
+                Lane t = (e > epsilon).select(((bb * s + f) / e).max(0.0).min(1.0), Lane::Zero(width));
+                if (aa > epsilon) {
+                    s = ((bb * t - c) / aa).max(0.0).min(1.0);
+                } else {
+                    s.setZero();
+                }
+
+                Lane dx = rx + d1.x() * s - d2x * t;
+                Lane dy = ry + d1.y() * s - d2y * t;
+                Lane dz = rz + d1.z() * s - d2z * t;
+                Lane distance = (dx * dx + dy * dy + dz * dz).sqrt() - radius_a(i) - radius_b(start, width);
+
+                // Compared column by column against the best pair found so far instead of Lane::minCoeff,
+                //   which reads the first coefficient before knowing the block is not empty
+                for (Eigen::Index column = 0; column < width; column++) {
+                    if (distance(column) < best.distance) {
+                        best = {i, start + column, distance(column)};
+                    }
+                }
+                if (best.distance < threshold) {
+                    return best;
+                }
+            }
+        }
+        return best;
+    }
+}
+
+SegmentPair closest_pair(const Eigen::Ref<const SegmentBuffer> &a, const Eigen::Ref<const SegmentBuffer> &b,
+                         double threshold) noexcept {
+    return closest_pair_kernel(a, [](Eigen::Index) { return 0.0; },
+                               b, [](Eigen::Index, Eigen::Index) { return 0.0; }, threshold);
+}
+
+SegmentPair closest_pair(const Eigen::Ref<const SegmentBuffer> &a, const Eigen::Ref<const Eigen::VectorXd> &radius_a,
+                         const Eigen::Ref<const SegmentBuffer> &b, const Eigen::Ref<const Eigen::VectorXd> &radius_b,
+                         double threshold) noexcept {
+    return closest_pair_kernel(a, [&radius_a](Eigen::Index i) { return radius_a(i); },
+                               b, [&radius_b](Eigen::Index start, Eigen::Index width) {
+                return radius_b.segment(start, width).transpose().array();
+            }, threshold);
+}
@@ -0,0 +1,148 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "line_table.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "precision.h"
+#include "vector.h"
+#include "dual_number.h"
+#include "../util/parallel.h"
+
+namespace {
+    constexpr Eigen::Index tile_size = 64;
+}
+
+LineTable::LineTable(const std::vector<UnitLine> &lines, bool angles, unsigned int threads)
+    : count(static_cast<Eigen::Index>(lines.size())) {
+    ScrewBuffer buffer(6, this->count);
+    for (Eigen::Index i = 0; i < this->count; i++) {
+        buffer.col(i) << lines[i].n().get(), lines[i].m().get();
+    }
+    if (angles) {
+        this->rotations.resize(this->count, this->count);
+    }
+    this->compute(buffer, threads);
+}
+
+LineTable::LineTable(const Eigen::Ref<const ScrewBuffer> &lines, bool angles, unsigned int threads)
+    : count(lines.cols()) {
+    if (angles) {
+        this->rotations.resize(this->count, this->count);
+    }
+    this->compute(lines, threads);
+}
+
+void LineTable::compute(const Eigen::Ref<const ScrewBuffer> &lines, unsigned int threads) {
+    this->relations.resize(this->count * this->count);
+    this->translations.resize(this->count, this->count);
+    const bool with_angles = this->rotations.size() > 0;
+
+    // Tiles of the upper triangle in row major order
+    const Eigen::Index tiles = (this->count + tile_size - 1) / tile_size;
+    const Eigen::Index triangle = tiles * (tiles + 1) / 2;
+
+    parallel_columns(triangle, threads, [&](Eigen::Index start, Eigen::Index width) {
+        // Find the row and column of the first tile of this chunk
+        Eigen::Index row = 0;
+        Eigen::Index column = start;
+        while (column >= tiles - row) {
+            column -= tiles - row;
+            row++;
+        }
+        column += row;
+
+        for (Eigen::Index tile = 0; tile < width; tile++) {
+            const Eigen::Index i_end = std::min(this->count, (row + 1) * tile_size);
+            const Eigen::Index j_end = std::min(this->count, (column + 1) * tile_size);
+
+            for (Eigen::Index j = column * tile_size; j < j_end; j++) {
+                const Eigen::Vector3d n2 = lines.col(j).head<3>();
+                const Eigen::Vector3d m2 = lines.col(j).tail<3>();
+
+                for (Eigen::Index i = row * tile_size; i < std::min(i_end, row == column ? j + 1 : i_end); i++) {
+                    const Eigen::Vector3d n1 = lines.col(i).head<3>();
+                    const Eigen::Vector3d m1 = lines.col(i).tail<3>();
+
+                    const double cosine = n1.dot(n2);
+                    const double sine = n1.cross(n2).norm();
+                    const bool parallel = Compare::is_zero(sine);
+
+                    double d;
+                    if (parallel) {
+                        // The sign follows UnitLine::get_distance(), which is negative for anti parallel lines
+                        const double orientation = cosine > 0 ? 1.0 : -1.0;
+                        d = orientation * (m2 - orientation * m1).norm();
+                    } else {
+                        d = -(n1.dot(m2) + n2.dot(m1)) / sine;
+                    }
+                    const bool shared_point = Compare::is_zero(d);
+
+                    LineRelation relation;
+                    if (parallel) {
+                        if (cosine > 0) {
+                            relation = shared_point ? COINCIDE : PARALLEL;
+                        } else {
+                            relation = shared_point ? ANTI_COINCIDE : ANTI_PARALLEL;
+                        }
+                    } else {
+                        relation = shared_point ? INTERSECT : SKEW;
+                    }
+
+                    this->relations[i + j * this->count] = relation;
+                    this->relations[j + i * this->count] = relation;
+                    this->translations(i, j) = d;
+                    this->translations(j, i) = d;
+                    if (with_angles) {
+                        double angle = std::atan2(sine, cosine);
+                        this->rotations(i, j) = angle;
+                        this->rotations(j, i) = angle;
+                    }
+                }
+            }
+
+            column++;
+            if (column == tiles) {
+                row++;
+                column = row;
+            }
+        }
+    }, 1);
+}
+
+Eigen::Index LineTable::size() const noexcept {
+    return this->count;
+}
+
+LineRelation LineTable::relation(Eigen::Index i, Eigen::Index j) const noexcept {
+    return this->relations[i + j * this->count];
+}
+
+DualNumberAlgebra::DualNumber LineTable::distance(Eigen::Index i, Eigen::Index j) const {
+    if (this->rotations.size() == 0) {
+        throw std::logic_error("The table was computed without angles");
+    }
+    return DualNumberAlgebra::DualNumber(this->rotations(i, j), this->translations(i, j));
+}
+
+const Eigen::MatrixXd &LineTable::translational_distances() const noexcept {
+    return this->translations;
+}
+
+const Eigen::MatrixXd &LineTable::angles() const noexcept {
+    return this->rotations;
+}
+
+bool LineTable::general_position() const noexcept {
+    for (Eigen::Index j = 0; j < this->count; j++) {
+        for (Eigen::Index i = 0; i < j; i++) {
+            if (this->relation(i, j) != SKEW) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
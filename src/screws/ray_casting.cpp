@@ -0,0 +1,162 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "ray_casting.h"
+
+#include <stdexcept>
+
+#include "../util/parallel.h"
+
+namespace {
+    /**
+     * \brief Row offsets in the structure of arrays
+     */
+    enum Row {
+        EDGE_N = 0, // Three directions, one per edge
+        EDGE_M = 9, // Three moments, one per edge
+        NORMAL = 18,
+        OFFSET = 21
+    };
+
+    /**
+     * \brief Number of triangles tested at once with fixed size temporaries
+     */
+    constexpr Eigen::Index BLOCK = 64;
+
+    using Block = Eigen::Array<double, 1, BLOCK>;
+
+    /**
+     * \brief Store the edges and the plane of a triangle in a column
+     */
+    void store_triangle(const Eigen::Ref<const PointBuffer> &vertices, int a, int b, int c,
+                        Eigen::Ref<Eigen::Array<double, OFFSET + 1, 1>> column) {
+        if (a < 0 || b < 0 || c < 0 || a >= vertices.cols() || b >= vertices.cols() || c >= vertices.cols()) {
+            throw std::invalid_argument("Vertex index out of range");
+        }
+
+        PointVector corners[3] = {
+                PointVector(Vector(vertices.col(a))),
+                PointVector(Vector(vertices.col(b))),
+                PointVector(Vector(vertices.col(c)))
+        };
+
+        Eigen::Matrix<double, 3, 1> normal = (corners[1] - corners[0]).get().cross((corners[2] - corners[0]).get());
+        if (Compare::is_zero(normal.norm())) {
+            throw std::invalid_argument("Degenerated triangle");
+        }
+
+        for (int edge = 0; edge < 3; edge++) {
+            // The edges are oriented around the triangle, so a ray through it is on the same side of all edges
+            UnitLine line(corners[edge], corners[(edge + 1) % 3]);
+            column.segment<3>(EDGE_N + 3 * edge) = line.n().get().array();
+            column.segment<3>(EDGE_M + 3 * edge) = line.m().get().array();
+        }
+        column.segment<3>(NORMAL) = normal.array();
+        column(OFFSET) = normal.dot(corners[0].get());
+    }
+
+    /**
+     * \brief The closest hit of one ray
+     */
+    RayHit closest_hit(const Eigen::Array<double, OFFSET + 1, Eigen::Dynamic> &triangles, const std::vector<int> &faces,
+                       const Eigen::Matrix<double, 3, 1> &origin, const Eigen::Matrix<double, 3, 1> &direction) noexcept {
+        // The moment of the ray
+        Eigen::Matrix<double, 3, 1> moment = origin.cross(direction);
+
+        RayHit hit;
+        Block side[3];
+        Block denominator;
+        Block distance;
+        for (Eigen::Index start = 0; start < triangles.cols(); start += BLOCK) {
+            Eigen::Index width = std::min(BLOCK, triangles.cols() - start);
+            auto block = triangles.middleCols(start, width);
+
+            // The reciprocal products n_r * m_e + m_r * n_e for all edges
+            for (int edge = 0; edge < 3; edge++) {
+                auto n = EDGE_N + 3 * edge;
+                auto m = EDGE_M + 3 * edge;
+                side[edge].leftCols(width) =
+                        direction(0) * block.row(m) + direction(1) * block.row(m + 1) + direction(2) * block.row(m + 2) +
+                        moment(0) * block.row(n) + moment(1) * block.row(n + 1) + moment(2) * block.row(n + 2);
+            }
+            denominator.leftCols(width) =
+                    direction(0) * block.row(NORMAL) + direction(1) * block.row(NORMAL + 1) + direction(2) * block.row(NORMAL + 2);
+            distance.leftCols(width) = (block.row(OFFSET) -
+                    origin(0) * block.row(NORMAL) - origin(1) * block.row(NORMAL + 1) - origin(2) * block.row(NORMAL + 2)) /
+                    denominator.leftCols(width);
+
+            for (Eigen::Index i = 0; i < width; i++) {
+                bool outside = (side[0](i) < 0 || side[1](i) < 0 || side[2](i) < 0) &&
+                               (side[0](i) > 0 || side[1](i) > 0 || side[2](i) > 0);
+                // Rays within the plane of the triangle are not counted as hit
+                if (outside || denominator(i) == 0) {
+                    continue;
+                }
+                if (distance(i) >= 0 && distance(i) < hit.distance) {
+                    hit.distance = distance(i);
+                    hit.face = faces[start + i];
+                }
+            }
+        }
+        return hit;
+    }
+}
+
+RayCaster::RayCaster(const Eigen::Ref<const PointBuffer> &vertices, const Eigen::Ref<const TriangleBuffer> &indices)
+    : triangles(ROWS, indices.cols()), faces(indices.cols()) {
+    for (Eigen::Index i = 0; i < indices.cols(); i++) {
+        store_triangle(vertices, indices(0, i), indices(1, i), indices(2, i), this->triangles.col(i));
+        this->faces[i] = static_cast<int>(i);
+    }
+}
+
+RayCaster RayCaster::FromPolygons(const Eigen::Ref<const PointBuffer> &vertices,
+                                  const std::vector<std::vector<int>> &polygons) {
+    // The triangles are counted first, so that the indices are allocated once
+    Eigen::Index triangles = 0;
+    for (const auto &corners : polygons) {
+        if (corners.size() < 3) {
+            throw std::invalid_argument("A polygon needs at least three vertices");
+        }
+        for (int corner : corners) {
+            if (corner < 0 || corner >= vertices.cols()) {
+                throw std::invalid_argument("Vertex index out of range");
+            }
+        }
+        triangles += static_cast<Eigen::Index>(corners.size()) - 2;
+    }
+
+    TriangleBuffer indices(3, triangles);
+    std::vector<int> faces;
+    faces.reserve(triangles);
+    for (std::size_t polygon = 0; polygon < polygons.size(); polygon++) {
+        const auto &corners = polygons[polygon];
+        // Fan triangulation is fine for convex polygons
+        for (std::size_t i = 1; i + 1 < corners.size(); i++) {
+            indices.col(static_cast<Eigen::Index>(faces.size())) << corners[0], corners[i], corners[i + 1];
+            faces.push_back(static_cast<int>(polygon));
+        }
+    }
+
+    RayCaster caster(vertices, indices);
+    caster.faces = faces;
+    return caster;
+}
+
+std::size_t RayCaster::size() const noexcept {
+    return this->faces.size();
+}
+
+RayHit RayCaster::cast(const UnitLine &ray, const PointVector &origin) const noexcept {
+    return closest_hit(this->triangles, this->faces, origin.get(), ray.n().get());
+}
+
+void RayCaster::cast(const Eigen::Ref<const PointBuffer> &origins, const Eigen::Ref<const PointBuffer> &directions,
+                     RayHit *hits, unsigned int threads) const {
+    parallel_columns(origins.cols(), threads, [&](Eigen::Index start, Eigen::Index width) {
+        for (Eigen::Index i = start; i < start + width; i++) {
+            hits[i] = closest_hit(this->triangles, this->faces, origins.col(i), directions.col(i));
+        }
+    }, 64);
+}
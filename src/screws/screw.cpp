@@ -6,6 +6,7 @@
 #include <iomanip>
 
 #include "dual_embedded_matrix.h"
+#include "dual_frame.h"
 
 #include "screw.h"
 #include "unit_line.h"
@@ -22,10 +23,14 @@ Screw::Screw(const DirectionVector &n, const MomentVector &m) noexcept : data(Ve
     this->data << n.get(), m.get();
 }
 
-DirectionVector Screw::n() const noexcept {
+DirectionVector Screw::n() const {
     return DirectionVector(this->data(0), this->data(1), this->data(2));
 }
 
+DirectionVector Screw::n(Unchecked) const noexcept {
+    return {this->data(0), this->data(1), this->data(2), unchecked};
+}
+
 MomentVector Screw::m() const noexcept {
     return MomentVector(this->data(3), this->data(4), this->data(5));
 }
@@ -45,6 +50,15 @@ DualNumberAlgebra::DualNumber Screw::operator*(const Screw &rhs) const noexcept
     return l.transpose() * r;
 }
 
+DualNumberAlgebra::DualNumber Screw::triple(const Screw &b, const Screw &c) const noexcept {
+    Eigen::Matrix<double, 3, 1> cross_n = b.data.head<3>().cross(c.data.head<3>());
+    Eigen::Matrix<double, 3, 1> cross_m = b.data.head<3>().cross(c.data.tail<3>()) + b.data.tail<3>().cross(c.data.head<3>());
+
+    return DualNumberAlgebra::DualNumber(
+            this->data.head<3>().dot(cross_n),
+            this->data.head<3>().dot(cross_m) + this->data.tail<3>().dot(cross_n));
+}
+
 DualNumberAlgebra::DualNumber Screw::norm() const noexcept {
     auto r = this->n().norm();
     auto d = this->n() * this->m() / r;
@@ -68,6 +82,61 @@ Screw Screw::operator-(const Screw &rhs) const {
     return Screw(this->data - rhs.data);
 }
 
+Screw Screw::ad(const Screw &rhs) const {
+    auto na = this->data.head<3>();
+    auto ma = this->data.tail<3>();
+    auto nb = rhs.data.head<3>();
+    auto mb = rhs.data.tail<3>();
+
+    Vec6 bracket;
+    bracket << na.cross(nb), na.cross(mb) + ma.cross(nb);
+
+    if (Compare::is_zero(bracket.head<3>().norm())) {
+        throw std::domain_error("Resulting direction would be zero");
+    }
+    return Screw(bracket);
+}
+
+Screw Screw::Ad(const DualFrame &frame) const noexcept {
+    const auto &R = frame.R().get();
+    Eigen::Matrix<double, 3, 3> pxR = frame.pxR().get();
+
+    Vec6 transformed;
+    transformed << R * this->data.head<3>(), pxR * this->data.head<3>() + R * this->data.tail<3>();
+    return Screw(transformed);
+}
+
+void Ad(const DualFrame &frame, const Eigen::Ref<const ScrewBuffer> &screws, Eigen::Ref<ScrewBuffer> result) noexcept {
+    const auto &R = frame.R().get();
+    Eigen::Matrix<double, 3, 3> pxR = frame.pxR().get();
+
+    // Work on blocks with a fixed size intermediate so the buffers may alias
+    constexpr Eigen::Index block = 32;
+    Eigen::Matrix<double, 6, block> transformed;
+    for (Eigen::Index start = 0; start < screws.cols(); start += block) {
+        Eigen::Index width = std::min(block, screws.cols() - start);
+        auto directions = screws.block(0, start, 3, width);
+        auto moments = screws.block(3, start, 3, width);
+
+        transformed.topLeftCorner(3, width).noalias() = R * directions;
+        transformed.bottomLeftCorner(3, width).noalias() = pxR * directions;
+        transformed.bottomLeftCorner(3, width).noalias() += R * moments;
+        result.middleCols(start, width) = transformed.leftCols(width);
+    }
+}
+
+void ad(const Screw &lhs, const Eigen::Ref<const ScrewBuffer> &screws, Eigen::Ref<ScrewBuffer> result) noexcept {
+    Eigen::Matrix<double, 3, 1> na = lhs.data.head<3>();
+    Eigen::Matrix<double, 3, 1> ma = lhs.data.tail<3>();
+
+    for (Eigen::Index i = 0; i < screws.cols(); i++) {
+        Eigen::Matrix<double, 3, 1> nb = screws.col(i).head<3>();
+        Eigen::Matrix<double, 3, 1> mb = screws.col(i).tail<3>();
+        result.col(i).head<3>() = na.cross(nb);
+        result.col(i).tail<3>() = na.cross(mb) + ma.cross(nb);
+    }
+}
+
 UnitLine Screw::to_line() const noexcept {
     return UnitLine(this->n().normal(), this->get_canonical_anchor());
 }
@@ -18,47 +18,134 @@ sgn(double x) {
 
 DualNumber
 UnitLine::acos3(const UnitLine &a, const UnitLine &b) const noexcept {
-    try {
-        // The orthogonals are not computable if something is coinciding
-        // In that case there is no transformation at all
-        // See the catch
-        UnitLine orthogonal_a = this->orthogonal(a).to_line();
-        UnitLine orthogonal_b = this->orthogonal(b).to_line();
-
-        // Check for (anti-)parallelity
-        bool an_parallel = Compare::is_equal(abs(a.n() * this->n()), 1.0);
-        bool bn_parallel = Compare::is_equal(abs(b.n() * this->n()), 1.0);
-
-        // Compute the orientiation of rotation by the triple product
-        // This may be 0 and thus yield to unprecise sign determination
-        // But it is not critical as it also means a half-circle rotation where the sign is completely irrelevant
-        double ornt = sgn( this->n() * cross(orthogonal_a.n(), orthogonal_b.n()) );
-        // Compute the rotation by the acos
-        auto arg = orthogonal_a.n() * orthogonal_b.n();
-        // Values need to be clipped due to floating point precision
-        if ( arg < -1) {arg = -1;}
-        if ( arg >  1) {arg =  1;}
-        // Compute the angle with its respective sign
-        double angle = acos(arg ) * ornt;
-
-        // The default translation with any parallel line is zero
-        double translation = 0;
-        if (!an_parallel && !bn_parallel) {
-            // This computes the distance of the orthogonal containing orthogonal plane to n
-            // Differently explained: This gives the constant offset of a Hesse normal form
-            // The orthogonal is obviously orthogonal to the line direction and thus inside a orthogonal plane
-            double plane_d_a = this->n() * orthogonal_a.get_canonical_anchor();
-            double plane_d_b = this->n() * orthogonal_b.get_canonical_anchor();
-
-            // The diffrence of the plane is the needed translation
-            translation = plane_d_b - plane_d_a;
+    // The orthogonals are not computable if something is coinciding
+    // In that case there is no transformation at all
+    Vec6 orthogonal_a_data;
+    Vec6 orthogonal_b_data;
+    if (!this->find_orthogonal(a, orthogonal_a_data) || !this->find_orthogonal(b, orthogonal_b_data)) {
+        return DualNumber(); // 0+0ϵ
+    }
+
+    UnitLine orthogonal_a = Screw(orthogonal_a_data).to_line();
+    UnitLine orthogonal_b = Screw(orthogonal_b_data).to_line();
+
+    // Check for (anti-)parallelity
+    bool an_parallel = Compare::is_equal(abs(a.n(unchecked) * this->n(unchecked)), 1.0);
+    bool bn_parallel = Compare::is_equal(abs(b.n(unchecked) * this->n(unchecked)), 1.0);
+
+    // Compute the orientiation of rotation by the triple product
+    // This may be 0 and thus yield to unprecise sign determination
+    // But it is not critical as it also means a half-circle rotation where the sign is completely irrelevant
+    double ornt = sgn( this->n(unchecked) * cross(orthogonal_a.n(unchecked), orthogonal_b.n(unchecked)) );
+    // Compute the rotation by the acos
+    auto arg = orthogonal_a.n(unchecked) * orthogonal_b.n(unchecked);
+    // Values need to be clipped due to floating point precision
+    if ( arg < -1) {arg = -1;}
+    if ( arg >  1) {arg =  1;}
+    // Compute the angle with its respective sign
+    double angle = acos(arg ) * ornt;
+
+    // The default translation with any parallel line is zero
+    double translation = 0;
+    if (!an_parallel && !bn_parallel) {
+        // This computes the distance of the orthogonal containing orthogonal plane to n
+        // Differently explained: This gives the constant offset of a Hesse normal form
+        // The orthogonal is obviously orthogonal to the line direction and thus inside a orthogonal plane
+        double plane_d_a = this->n() * orthogonal_a.get_canonical_anchor();
+        double plane_d_b = this->n() * orthogonal_b.get_canonical_anchor();
+
+        // The diffrence of the plane is the needed translation
+        translation = plane_d_b - plane_d_a;
+    }
+
+    return DualNumber(
+            angle,
+            translation
+    );
+}
+
+namespace {
+    constexpr Eigen::Index lane_width = 64;
+    using Lane = Eigen::Array<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, lane_width>;
+    using Lanes = Eigen::Array<double, 3, Eigen::Dynamic, Eigen::ColMajor, 3, lane_width>;
+
+    Lanes cross(const Eigen::Vector3d &lhs, const Lanes &rhs) noexcept {
+        Lanes result(3, rhs.cols());
+        result.row(0) = lhs.y() * rhs.row(2) - lhs.z() * rhs.row(1);
+        result.row(1) = lhs.z() * rhs.row(0) - lhs.x() * rhs.row(2);
+        result.row(2) = lhs.x() * rhs.row(1) - lhs.y() * rhs.row(0);
+        return result;
+    }
+
+    Lanes cross(const Lanes &lhs, const Lanes &rhs) noexcept {
+        Lanes result(3, rhs.cols());
+        result.row(0) = lhs.row(1) * rhs.row(2) - lhs.row(2) * rhs.row(1);
+        result.row(1) = lhs.row(2) * rhs.row(0) - lhs.row(0) * rhs.row(2);
+        result.row(2) = lhs.row(0) * rhs.row(1) - lhs.row(1) * rhs.row(0);
+        return result;
+    }
+
+    Lane dot(const Eigen::Vector3d &lhs, const Lanes &rhs) noexcept {
+        return lhs.x() * rhs.row(0) + lhs.y() * rhs.row(1) + lhs.z() * rhs.row(2);
+    }
+
+    /**
+     * \brief The orthogonals of the reference with a block of lines as in UnitLine::find_orthogonal
+     */
+    struct Orthogonals {
+        Lanes direction; //!< Normalized direction of each orthogonal
+        Lane offset; //!< Offset of the plane orthogonal to the reference containing the orthogonal
+        Eigen::Array<bool, 1, Eigen::Dynamic, Eigen::RowMajor, 1, lane_width> coincide; //!< No orthogonal exists
+        Eigen::Array<bool, 1, Eigen::Dynamic, Eigen::RowMajor, 1, lane_width> parallel; //!< Parallel to the reference
+
+        Orthogonals(const Eigen::Vector3d &n, const Eigen::Vector3d &m,
+                    const Eigen::Ref<const ScrewBuffer> &lines, Eigen::Index start, Eigen::Index width) noexcept {
+            const double epsilon = Compare::instance().get_precision();
+            const Lanes ln = lines.block(0, start, 3, width).array();
+            const Lanes lm = lines.block(3, start, 3, width).array();
+
+            // na x nb, or na x mb + ma x nb with the moment ma x mb for parallel lines
+            const Lanes cross_n = cross(n, ln);
+            const Lanes cross_nm = cross(n, lm) + cross(m, ln);
+            const Lanes cross_m = cross(m, lm);
+            const auto primary = (cross_n.square().colwise().sum().sqrt() >= epsilon).replicate(3, 1);
+            const Lanes on = primary.select(cross_n, cross_nm);
+            const Lanes om = primary.select(cross_nm, cross_m);
+
+            // The direction and canonical anchor as in Screw::to_line
+            const Lane squared_norm = on.square().colwise().sum();
+            this->coincide = squared_norm.sqrt() < epsilon;
+            this->direction = on.rowwise() / squared_norm.sqrt();
+            this->offset = dot(n, cross(on, om)) / squared_norm;
+            this->parallel = (dot(n, ln).abs() - 1.0).abs() < epsilon;
         }
+    };
+}
 
-        return DualNumber(
-                angle,
-                translation
-        );
-    } catch(const std::domain_error &e) {
-        return DualNumber(); // 0+0ϵ
+void acos3_batch(const UnitLine &reference, const Eigen::Ref<const ScrewBuffer> &a,
+                 const Eigen::Ref<const ScrewBuffer> &b, Eigen::Ref<DualBuffer> result) noexcept {
+    const Eigen::Vector3d n = reference.n(unchecked).get();
+    const Eigen::Vector3d m = reference.m().get();
+
+    for (Eigen::Index start = 0; start < a.cols(); start += lane_width) {
+        const Eigen::Index width = std::min(lane_width, a.cols() - start);
+        const Orthogonals oa(n, m, a, start, width);
+        const Orthogonals ob(n, m, b, start, width);
+
+        const Lane orientation = (dot(n, cross(oa.direction, ob.direction)) > 0).select(
+                Lane::Ones(width), Lane::Constant(width, -1.0));
+        const Lane angle = (oa.direction * ob.direction).colwise().sum().max(-1.0).min(1.0).acos() * orientation;
+
+        const auto coincide = oa.coincide || ob.coincide;
+        result.block(0, start, 1, width) = coincide.select(Lane::Zero(width), angle).matrix();
+        result.block(1, start, 1, width) = (coincide || oa.parallel || ob.parallel).select(
+                Lane::Zero(width), ob.offset - oa.offset).matrix();
     }
 }
+
+void acos3_batch(const UnitLine &reference, const double *a, const double *b, double *result,
+                 std::size_t count) noexcept {
+    auto size = static_cast<Eigen::Index>(count);
+    acos3_batch(reference, Eigen::Map<const ScrewBuffer>(a, 6, size), Eigen::Map<const ScrewBuffer>(b, 6, size),
+                Eigen::Map<DualBuffer>(result, 2, size));
+}
@@ -0,0 +1,133 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "subproblems.h"
+
+#include "dual_skew_product.h"
+#include "dual_frame.h"
+#include "vector.h"
+
+#include "precision.h"
+
+using DualNumberAlgebra::DualNumber;
+
+namespace {
+    /**
+     * \brief Coefficients of the generalized rodriguez formula for reference * (M(phi) * l)
+     *
+     * The product is given by a cos(phi) + b sin(phi) + c
+     *
+     * For a unit line as dual vector the dual skew is the dual cross product.
+     * Thus the projections of the rodriguez formula reduce to dual dot and triple products:
+     *   uniterm * l = l - (axis * l) axis
+     *   squareterm * l = (axis * l) axis
+     */
+    std::tuple<DualNumber, DualNumber, DualNumber>
+    rodriguez_coefficients(const UnitLine &axis, const UnitLine &l, const UnitLine &reference) {
+        DualNumber projection = (axis * l) * (reference * axis);
+
+        return std::make_tuple(
+                reference * l - projection,
+                reference.triple(axis, l),
+                projection);
+    }
+}
+
+namespace Subproblem {
+    DualNumber transform_onto(const UnitLine &axis, const UnitLine &a, const UnitLine &b) {
+        // The dual inner product with the axis is invariant to transformations around the axis
+        auto difference = axis * a - axis * b;
+        if (!Compare::is_zero(difference.real()) || !Compare::is_zero(difference.dual())) {
+            throw std::domain_error("Line cannot be transformed onto the other line around the axis");
+        }
+        return axis.acos3(a, b);
+    }
+
+    DualNumber transform_onto(const UnitLine &axis, const UnitLine &a, const UnitLine &b, JointType type) noexcept {
+        Eigen::Matrix<double, 3, 1> n = axis.n(unchecked).get();
+        Eigen::Matrix<double, 3, 1> na = a.n(unchecked).get();
+        Eigen::Matrix<double, 3, 1> w = n.cross(na);
+
+        switch (type) {
+            case JointType::REVOLUTE: {
+                if (Compare::is_zero(w.norm())) {
+                    // The direction of a parallel line does not change, only its position
+                    return DualNumber(axis.acos3(a, b).real(), 0);
+                }
+                // The angle between the directions projected to the plane orthogonal to the axis
+                Eigen::Matrix<double, 3, 1> nb = b.n(unchecked).get();
+                return DualNumber(std::atan2(n.dot(na.cross(nb)), na.dot(nb) - n.dot(na) * n.dot(nb)), 0);
+            }
+            case JointType::PRISMATIC: {
+                if (Compare::is_zero(w.norm())) {
+                    return DualNumber(0, 0);
+                }
+                // Translating a by d along the axis changes its moment by d (n x na)
+                Eigen::Matrix<double, 3, 1> moment_change = b.m().get() - a.m().get();
+                return DualNumber(0, moment_change.dot(w) / w.squaredNorm());
+            }
+            default:
+                return axis.acos3(a, b);
+        }
+    }
+
+    std::vector<std::pair<DualNumber, DualNumber>>
+    transform_onto(const UnitLine &first, const UnitLine &second, const UnitLine &a, const UnitLine &b) {
+        // The first transformation does not change the dual inner product with the first axis
+        // Thus first * (M2 * a) = first * b has to hold which is a trigonometric equation
+        DualNumber cos_factor, sin_factor, constant;
+        std::tie(cos_factor, sin_factor, constant) = rodriguez_coefficients(second, a, first);
+
+        std::vector<std::pair<DualNumber, DualNumber>> solutions;
+        for (const auto &phi_2 : DualNumberAlgebra::solve_trigonometric_equation(cos_factor, sin_factor, first * b - constant)) {
+            auto intermediate = DualFrame(DualSkewProduct(second, phi_2)) * a;
+            solutions.emplace_back(first.acos3(intermediate, b), phi_2);
+        }
+        return solutions;
+    }
+
+    std::vector<DualNumber>
+    transform_to_distance(const UnitLine &axis, const UnitLine &a, const UnitLine &b, const DualNumber &distance) {
+        DualNumber cos_factor, sin_factor, constant;
+        std::tie(cos_factor, sin_factor, constant) = rodriguez_coefficients(axis, a, b);
+
+        // The dual inner product of unit lines is the dual cosine of their distance
+        return DualNumberAlgebra::solve_trigonometric_equation(cos_factor, sin_factor, cos(distance) - constant);
+    }
+
+    std::vector<DualNumber>
+    transform_to_distance(const UnitLine &axis, const UnitLine &a, const UnitLine &b, const DualNumber &distance,
+                          JointType type) {
+        if (type == JointType::CYLINDRICAL) {
+            return transform_to_distance(axis, a, b, distance);
+        }
+
+        DualNumber cos_factor, sin_factor, constant;
+        std::tie(cos_factor, sin_factor, constant) = rodriguez_coefficients(axis, a, b);
+        DualNumber offset = cos(distance) - constant;
+
+        if (type == JointType::PRISMATIC) {
+            // For phi = 0 + d eps the equation is linear: a + b d eps = offset
+            if (Compare::is_zero(sin_factor.real())) {
+                throw std::domain_error("Distance does not depend on the translation");
+            }
+            return {DualNumber(0, (offset.dual() - cos_factor.dual()) / sin_factor.real())};
+        }
+
+        // Revolute: only the real parts of a cos + b sin = c
+        double discriminant = cos_factor.real() * cos_factor.real() + sin_factor.real() * sin_factor.real()
+                - offset.real() * offset.real();
+        if (discriminant < 0 && !Compare::is_zero(discriminant)) {
+            throw std::domain_error("No solution possible");
+        }
+
+        double pre = std::atan2(sin_factor.real(), cos_factor.real());
+        if (Compare::is_zero(discriminant)) {
+            // The sign of the offset decides between the maximum and the minimum
+            return {DualNumber(pre + std::atan2(0.0, offset.real()), 0)};
+        }
+        double rad = std::atan2(std::sqrt(discriminant), offset.real());
+        return {DualNumber(pre + rad, 0), DualNumber(pre - rad, 0)};
+    }
+}
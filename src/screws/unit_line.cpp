@@ -21,6 +21,8 @@ UnitLine::UnitLine(const UnitDirectionVector &n, const MomentVector &m) : Screw(
     }
 }
 
+UnitLine::UnitLine(const UnitDirectionVector &n, const MomentVector &m, Unchecked) noexcept : Screw(n, m) {}
+
 UnitLine::UnitLine(const DirectionVector &n, const PointVector &a) noexcept : UnitLine(n.normal(), a) {}
 
 UnitLine::UnitLine(const PointVector &a, const PointVector &b) : UnitLine(DirectionVector(b-a).normal(), a){}
@@ -30,7 +32,14 @@ UnitLine UnitLine::operator-() const noexcept {
 }
 
 UnitLine operator*(const DualFrame &lhs, const UnitLine &rhs) noexcept {
-    return UnitLine(lhs.data * rhs.data);
+    const auto &R = lhs.R().get();
+    const auto &p = lhs.p().get();
+
+    // The moment of the transformed line is R m + p x R n
+    UnitLine::Vec6 data;
+    data << R * rhs.data.head<3>(), R * rhs.data.tail<3>();
+    data.tail<3>() += p.cross(data.head<3>());
+    return UnitLine(data);
 }
 
 Screw UnitLine::transform(DualNumberAlgebra::DualNumber value) const noexcept {
@@ -50,28 +59,33 @@ std::tuple<Screw, Screw, Screw> UnitLine::decomposition(const Screw &l) const {
     return std::make_tuple(ortho,rej, proj);
 }
 
-Screw UnitLine::orthogonal(const Screw &l) const {
+bool UnitLine::find_orthogonal(const Screw &l, Vec6 &result) const noexcept {
     Vector nm = this->n().cross(l.m()) + this->m().cross(l.n()); // na x mb + ma x nb
-    try {
-        return Screw(
-                DirectionVector(this->n().cross(l.n())),// na x nb
-                MomentVector(nm) // na x mb + ma x nb
-        );
-    } catch(const std::invalid_argument &) {
-        try {
-            // this is structural the same as above, but it needs swapping which is not possible with the types used here
-            // the result could be a direction with zero-norm
-            // another type with switched direction and moment would be necessary or something like that
-            // but this would be much work only for this purpose.
-            return Screw(
-                    DirectionVector(nm), // na x mb + ma x nb
-                    MomentVector(this->m().cross(l.m())) // ma x mb
-                    );
-
-        } catch(const std::invalid_argument &) {
-            throw std::domain_error("Orthogonal of coinciding lines is not possible");
-        }
+    Vector direction = this->n(unchecked).cross(l.n(unchecked)); // na x nb
+
+    if (!direction.is_zero()) {
+        result << direction.get(), nm.get();
+        return true;
+    }
+
+    // this is structural the same as above, but it needs swapping which is not possible with the types used here
+    // the result could be a direction with zero-norm
+    // another type with switched direction and moment would be necessary or something like that
+    // but this would be much work only for this purpose.
+    if (!nm.is_zero()) {
+        result << nm.get(), this->m().cross(l.m()).get(); // ma x mb
+        return true;
+    }
+
+    return false;
+}
+
+Screw UnitLine::orthogonal(const Screw &l) const {
+    Vec6 result;
+    if (!this->find_orthogonal(l, result)) {
+        throw std::domain_error("Orthogonal of coinciding lines is not possible");
     }
+    return Screw(result);
 }
 
 Screw UnitLine::rejection(const Screw &l, const Screw *orthogonal) const {
@@ -84,19 +98,28 @@ Screw UnitLine::rejection(const Screw &l, const Screw *orthogonal) const {
 }
 
 Screw UnitLine::projection(const Screw &l, const Screw *rejection) const noexcept {
-    try {
+    Vec6 r;
+    if (rejection != nullptr) {
+        r = rejection->data;
+    } else {
         // It is possible that the rejection cannot be calculated.
         // This mostly means that the lines are coinciding.
-        const Screw &r = (rejection == nullptr) ? this->rejection(l) : *rejection;
-
-        // the projection is the the part of the screw, which does not contain anyhting from the rejection.
-        // regarding lines it does not make much sense but in screws the pitches are different
-        auto p = l - r;
-        return p;
-    } catch(const std::domain_error &) {
         // It doubt the reference line itself is a good projection as without respect of the norm/pitch it is always the same line.
+        Vec6 o;
+        if (!this->find_orthogonal(l, o) || !this->find_orthogonal(Screw(o), r)) {
+            return *this;
+        }
+        // The rejection is the negated double orthogonal
+        r = -r;
+    }
+
+    // the projection is the the part of the screw, which does not contain anyhting from the rejection.
+    // regarding lines it does not make much sense but in screws the pitches are different
+    // The difference is not possible for equal directions, see Screw::operator-
+    if (l.n() == Screw(r).n()) {
         return *this;
     }
+    return Screw(l.data - r);
 }
 
 PointVector UnitLine::point_project(const UnitLine &l) const noexcept {
@@ -164,15 +187,14 @@ UnitLine::intersect(const UnitLine &l) const {
 
 DualNumberAlgebra::DualNumber UnitLine::get_distance(const UnitLine &rhs) const noexcept {
     auto n1 = this->n();
-    auto n2 = rhs.n();
+    auto n2 = rhs.n(unchecked);
 
 
+    // Coinciding lines have no orthogonal direction and no distance
     double d = 0;
-    try {
-        auto n12 = this->line_cross(rhs);
-        d = (n1.cross(this->m()) - n2.cross(rhs.m())) * n12.normal();
-    } catch(...) {
-        // Do nothing
+    auto n12 = this->find_line_cross(rhs);
+    if (!n12.is_zero()) {
+        d = (n1.cross(this->m()) - n2.cross(rhs.m())) * (n12 / n12.norm());
     }
 
     double prod = n1 * n2;
@@ -185,16 +207,20 @@ DualNumberAlgebra::DualNumber UnitLine::get_distance(const UnitLine &rhs) const
             );
 }
 
+Vector UnitLine::find_line_cross(const UnitLine &rhs) const noexcept {
+    Vector direction = this->n(unchecked).cross(rhs.n(unchecked)); // na x nb
+    if (direction.is_zero()) {
+        return this->n().cross(rhs.m()) + this->m().cross(rhs.n()); // na x mb + ma x nb
+    }
+    return direction;
+}
+
 DirectionVector UnitLine::line_cross(const UnitLine &rhs) const {
-    try {
-        return DirectionVector(this->n().cross(rhs.n())); // na x nb
-    } catch(const std::invalid_argument &) {
-        try {
-            return DirectionVector(this->n().cross(rhs.m()) + this->m().cross(rhs.n())); // na x mb + ma x nb
-        } catch(const std::invalid_argument &) {
-            throw std::domain_error("Orthogonal direction of coinciding lines is not possible");
-        }
+    auto direction = this->find_line_cross(rhs);
+    if (direction.is_zero()) {
+        throw std::domain_error("Orthogonal direction of coinciding lines is not possible");
     }
+    return {direction, unchecked};
 }
 
 double UnitLine::get_distance(const PointVector &rhs) const noexcept {
@@ -237,14 +263,11 @@ LineRelation UnitLine::get_relation_to(const UnitLine &l) const noexcept {
 
 UnitLine UnitLine::orthogonal_through_anchor(const PointVector &anchor) const {
     UnitLine l = this->to_line();
-    try {
-        DirectionVector n(
-                anchor - cross(l.n(), l.m()) - l.n() * (l.n() * anchor)
-        );
-        return UnitLine(n, anchor);
-    } catch( std::invalid_argument &) {
+    Vector n = anchor - cross(l.n(), l.m()) - l.n() * (l.n() * anchor);
+    if (n.is_zero()) {
         throw std::domain_error("Cannot create a orthogonal through anchor if the anchor is on the line");
     }
+    return UnitLine(DirectionVector(n, unchecked), anchor);
 }
 
 PointVector UnitLine::point_project(const PointVector &p) const noexcept {
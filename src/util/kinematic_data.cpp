@@ -0,0 +1,53 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include "kinematic_data.h"
+
+LineData to_data(const UnitLine &line) noexcept {
+    LineData data{};
+    Eigen::Map<Eigen::Matrix<double, 6, 1>>(reinterpret_cast<double *>(&data)) = line.data;
+    return data;
+}
+
+FrameData to_data(const DualFrame &frame) noexcept {
+    FrameData data{};
+    Eigen::Map<Eigen::Matrix<double, 3, 3>>(data.R) = frame.R().get();
+    Eigen::Map<Eigen::Matrix<double, 3, 1>>(data.p) = frame.p().get();
+    return data;
+}
+
+ConfigData to_data(const Configuration &configuration) noexcept {
+    return {
+        {configuration.phi_1.real(), configuration.phi_2.real(), configuration.phi_3.real()},
+        {configuration.phi_1.dual(), configuration.phi_2.dual(), configuration.phi_3.dual()}
+    };
+}
+
+UnitLine to_line(const LineData &data) noexcept {
+    return UnitLine(Eigen::Map<const Eigen::Matrix<double, 6, 1>>(reinterpret_cast<const double *>(&data)));
+}
+
+DualFrame to_frame(const FrameData &data) noexcept {
+    return {
+        RotationMatrix::RotationFromEigen(Eigen::Map<const Eigen::Matrix<double, 3, 3>>(data.R), unchecked),
+        PointVector(data.p[0], data.p[1], data.p[2])
+    };
+}
+
+Configuration to_configuration(const ConfigData &data) noexcept {
+    return {
+        DualNumberAlgebra::DualNumber(data.angle[0], data.distance[0]),
+        DualNumberAlgebra::DualNumber(data.angle[1], data.distance[1]),
+        DualNumberAlgebra::DualNumber(data.angle[2], data.distance[2])
+    };
+}
+
+Eigen::Map<ScrewBuffer> view(LineData *data, std::size_t count) noexcept {
+    // Standard layout without padding, so the lines are contiguous doubles
+    return {reinterpret_cast<double *>(data), 6, static_cast<Eigen::Index>(count)};
+}
+
+Eigen::Map<const ScrewBuffer> view(const LineData *data, std::size_t count) noexcept {
+    return {reinterpret_cast<const double *>(data), 6, static_cast<Eigen::Index>(count)};
+}
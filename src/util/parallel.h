@@ -0,0 +1,77 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#ifndef DUAL_ALGEBRA_KINEMATICS_PARALLEL_H
+#define DUAL_ALGEBRA_KINEMATICS_PARALLEL_H
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <eigen3/Eigen/Eigen>
+
+/**
+ * \brief Split the columns into contiguous chunks and work on them in parallel
+ *
+ * Small buffers are not split as the thread creation is more expensive than the work.
+ * This is only used internally by the batch functions.
+ * The calling thread works on the first chunk and all started threads are joined before returning, also on an error.
+ * The first exception of a chunk, or of starting a thread, is rethrown to the caller.
+ * @param count Number of columns
+ * @param threads Maximum number of threads
+ * @param work Callable with the first column and the number of columns of a chunk
+ * @param minimum_chunk The least number of columns worth a thread
+ */
+template<typename Work>
+void parallel_columns(Eigen::Index count, unsigned int threads, const Work &work, Eigen::Index minimum_chunk = 4096) {
+    auto chunks = std::min<Eigen::Index>(std::max(threads, 1u), count / minimum_chunk);
+
+    if (chunks <= 1) {
+        work(0, count);
+        return;
+    }
+
+    Eigen::Index chunk = (count + chunks - 1) / chunks;
+    std::vector<std::exception_ptr> errors(static_cast<std::size_t>(chunks));
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+
+    // Joins the started threads on every way out, destroying a joinable thread would terminate
+    struct Joiner {
+        std::vector<std::thread> &workers;
+
+        ~Joiner() {
+            for (auto &worker : this->workers) {
+                if (worker.joinable()) {
+                    worker.join();
+                }
+            }
+        }
+    } joiner{workers};
+
+    auto guarded = [&work, &errors](std::size_t slot, Eigen::Index start, Eigen::Index width) noexcept {
+        try {
+            work(start, width);
+        } catch (...) {
+            errors[slot] = std::current_exception();
+        }
+    };
+    std::size_t slot = 1;
+    for (Eigen::Index start = chunk; start < count; start += chunk, slot++) {
+        workers.emplace_back(guarded, slot, start, std::min(chunk, count - start));
+    }
+    guarded(0, 0, chunk);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+#endif //DUAL_ALGEBRA_KINEMATICS_PARALLEL_H
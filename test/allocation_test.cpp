@@ -0,0 +1,245 @@
+//
+// Created by sba on 19.10.26.
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "dual_frame.h"
+#include "unit_line.h"
+#include "ccc.h"
+#include "line_chain.h"
+#include "forward_cache.h"
+#include "line_segment.h"
+
+#include <gtest/gtest.h>
+
+using namespace DualNumberAlgebra;
+
+// Every heap allocation of the process is counted.
+// The tests only compare the counter before and after the checked calls.
+namespace {
+    std::atomic<std::size_t> allocations(0);
+}
+
+#ifdef __GLIBC__
+// Also Eigen and C code allocate with malloc, so the glibc allocator is wrapped as well
+extern "C" {
+    void *__libc_malloc(std::size_t size);
+    void *__libc_calloc(std::size_t count, std::size_t size);
+    void *__libc_realloc(void *pointer, std::size_t size);
+
+    void *malloc(std::size_t size) {
+        allocations++;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(std::size_t count, std::size_t size) {
+        allocations++;
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *pointer, std::size_t size) {
+        allocations++;
+        return __libc_realloc(pointer, size);
+    }
+}
+#define ALLOCATE(size) __libc_malloc(size)
+#else
+#define ALLOCATE(size) std::malloc(size)
+#endif
+
+void *operator new(std::size_t size) {
+    allocations++;
+    void *pointer = ALLOCATE(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+/**
+ * \brief Run the callable and return the number of heap allocations it did
+ */
+template<typename Work>
+std::size_t count_allocations(const Work &work) {
+    std::size_t before = allocations.load();
+    work();
+    return allocations.load() - before;
+}
+
+class Allocation : public testing::Test {
+protected:
+    void SetUp() override {
+        this->mechanism = new CCCMechanism(
+                UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+                UnitLine(PointVector(0, 1, 0), PointVector(1, 1, 1)),
+                UnitLine(PointVector(1, 0, 2), PointVector(1, 2, 2)),
+                DualFrame(RotationMatrix(0.1, 0.2, 0.3), PointVector(1, 2, 3)));
+    }
+
+    void TearDown() override {
+        delete this->mechanism;
+    }
+
+    CCCMechanism *mechanism = nullptr;
+};
+
+// The allocation counter itself has to work, otherwise all other tests are meaningless
+// The allocation functions are called directly and the pointers are volatile,
+//   so an optimizing compiler cannot remove the unused allocations
+TEST_F(Allocation, Counter) { // NOLINT
+    EXPECT_GT(count_allocations([]() {
+        void *volatile pointer = ::operator new(sizeof(int));
+        ::operator delete(pointer);
+    }), 0u);
+    EXPECT_GT(count_allocations([]() {
+        void *volatile pointer = std::malloc(16);
+        std::free(pointer);
+    }), 0u);
+    EXPECT_GT(count_allocations([]() { Eigen::MatrixXd m(10, 10); m.setZero(); }), 0u);
+}
+
+TEST_F(Allocation, Kinematics) { // NOLINT
+    Configuration configuration = {DualNumber(0.5, 1), DualNumber(-0.3, 0.2), DualNumber(1.2, -1)};
+    DualFrame pose = this->mechanism->forward(configuration);
+    // The first and third line are parallel and the second one is inclined by 45°
+    // So the third line can never be turned upside down
+    CCCMechanism limited(
+            UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+            UnitLine(PointVector(0, 0, 0), PointVector(1, 0, 1)),
+            UnitLine(PointVector(1, 0, 0), PointVector(1, 0, 1)),
+            DualFrame(RotationMatrix(0, 0, 0), PointVector(0, 0, 0)));
+    DualFrame unreachable(RotationMatrix(0, M_PI, 0), PointVector(1, 2, 3));
+    std::array<Configuration, 3> solutions;
+    std::size_t count = 0;
+    std::size_t unreachable_count = 1;
+    double buffer[16];
+    Eigen::Matrix<double, 6, 6> jacobian;
+    ForwardCache cache(*this->mechanism, configuration);
+
+    auto allocated = count_allocations([&]() {
+        pose = this->mechanism->forward(configuration);
+        this->mechanism->forward(configuration, buffer);
+        auto verbose = this->mechanism->forward_verbose(configuration);
+        pose = std::get<0>(verbose);
+        count = this->mechanism->inverse(pose, solutions);
+        unreachable_count = limited.inverse(unreachable, solutions);
+        count = this->mechanism->inverse(pose, solutions);
+        for (auto solution : this->mechanism->inverse_lazy(pose, std::nothrow)) {
+            configuration = solution;
+        }
+        jacobian = this->mechanism->jacobian(configuration);
+        cache.set_phi_3(DualNumber(0.1, 0.1));
+        cache.update(configuration);
+    });
+
+    EXPECT_EQ(allocated, 0u);
+    EXPECT_GT(count, 0u);
+    EXPECT_EQ(unreachable_count, 0u);
+    for (std::size_t i = 0; i < count; i++) {
+        EXPECT_EQ(this->mechanism->forward(solutions[i]), pose);
+    }
+}
+
+TEST_F(Allocation, Line_Operations) { // NOLINT
+    UnitLine a(PointVector(0, 0, 0), PointVector(0, 0, 1));
+    UnitLine b(PointVector(1, 0, 0), PointVector(1, 1, 1));
+    UnitLine c(PointVector(0, 1, 2), PointVector(1, 2, 2));
+    DualFrame frame(RotationMatrix(0.3, 0.2, 0.1), PointVector(-1, 0, 1));
+
+    LineChain<3> chain{{a, b, c}, frame};
+    LineChain<3>::Values values = {DualNumber(0.1, 0.2), DualNumber(0.3, 0.4), DualNumber(0.5, 0.6)};
+
+    DualNumber angle;
+    LineRelation relation = SKEW;
+    auto allocated = count_allocations([&]() {
+        // Coinciding and parallel lines are the cases which formerly used exceptions internally
+        angle = a.acos3(a, b) + a.acos3(b, c) + a.get_distance(a) + a.get_distance(b);
+        relation = a.get_relation_to(-a);
+        auto projection = a.projection(a);
+        auto transformed = frame * (frame.inverse() * c);
+        angle += transformed.get_distance(projection.to_line());
+        auto fk = chain.forward(values);
+        frame = fk * DualFrame(DualSkewProduct(a, angle));
+    });
+
+    EXPECT_EQ(allocated, 0u);
+    EXPECT_EQ(relation, ANTI_COINCIDE);
+}
+
+TEST_F(Allocation, Segment_Distances) { // NOLINT
+    SegmentBuffer links = SegmentBuffer::Random(6, 5);
+    SegmentBuffer obstacles = SegmentBuffer::Random(6, 200);
+    Eigen::VectorXd link_radii = Eigen::VectorXd::Constant(5, 0.01);
+    Eigen::VectorXd obstacle_radii = Eigen::VectorXd::Constant(200, 0.02);
+    LineSegment first(PointVector(0, 0, 0), PointVector(1, 0, 0));
+    LineSegment second(PointVector(0, 1, 0), PointVector(1, 1, 1));
+
+    SegmentPair pair, capsule_pair;
+    double distance = 0;
+    auto allocated = count_allocations([&]() {
+        pair = closest_pair(links, obstacles);
+        capsule_pair = closest_pair(links, link_radii, obstacles, obstacle_radii, 0.0);
+        distance = first.get_distance(second);
+    });
+
+    EXPECT_EQ(allocated, 0u);
+    EXPECT_GE(pair.first, 0);
+    EXPECT_GE(capsule_pair.first, 0);
+    EXPECT_NEAR(distance, 1, 1e-12);
+}
+
+TEST_F(Allocation, Acos3_Batch) { // NOLINT
+    UnitLine reference(PointVector(0, 0, 0), PointVector(0, 0, 1));
+    ScrewBuffer lines(6, 100);
+    for (Eigen::Index i = 0; i < lines.cols(); i++) {
+        UnitLine line(PointVector(Vector(Eigen::Vector3d::Random())), PointVector(Vector(Eigen::Vector3d::Random())));
+        lines.col(i) << line.n().get(), line.m().get();
+    }
+    ScrewBuffer reversed = lines.rowwise().reverse();
+    DualBuffer result(2, lines.cols());
+
+    auto allocated = count_allocations([&]() {
+        acos3_batch(reference, lines, reversed, result);
+    });
+
+    EXPECT_EQ(allocated, 0u);
+}
+
+TEST_F(Allocation, Trigonometric_Batch) { // NOLINT
+    DualBuffer cos_factors = DualBuffer::Random(2, 100);
+    DualBuffer sin_factors = DualBuffer::Random(2, 100);
+    DualBuffer offsets = DualBuffer::Random(2, 100);
+    DualBuffer first(2, 100);
+    DualBuffer second(2, 100);
+    Eigen::VectorXi counts(100);
+
+    auto allocated = count_allocations([&]() {
+        DualNumberAlgebra::solve_trigonometric_equations(cos_factors, sin_factors, offsets,
+                                                         first, second, counts);
+    });
+
+    EXPECT_EQ(allocated, 0u);
+}
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <random>
 #include <chrono>
+#include <cstring>
+#include <limits>
 
 #include "vector.h"
 #include "dual_number.h"
@@ -18,6 +20,13 @@
 #include "dual_skew_product.h"
 
 #include "ccc.h"
+#include "line_chain.h"
+#include "structured_mechanism.h"
+#include "kinematic_data.h"
+#include "forward_cache.h"
+#include "axis_identification.h"
+#include "calibration.h"
+#include "random.h"
 
 #include <gtest/gtest.h>
 
@@ -207,3 +216,646 @@ TEST(Mechanism, Orthogonal_Enforced_Frames) { // NOLINT
         }
     }
 }
+
+TEST(Mechanism, Lazy_Inverse) { // NOLINT
+    CCCMechanism su = create_SU();
+
+    std::vector<DualFrame> frames = {
+            DualFrame(RotationMatrix(0,0,0), PointVector(0,0,-5)),
+            DualFrame(RotationMatrix(M_PI_2,M_PI_2,0), PointVector(0,3,-5)),
+            DualFrame(RotationMatrix(M_PI_4, 0, M_PI_4), PointVector(1, 0, 0))
+    };
+
+    for (const auto &frame : frames) {
+        auto configs = su.inverse(frame);
+        auto lazy = su.inverse_lazy(frame);
+
+        ASSERT_EQ(configs.size(), lazy.size());
+
+        std::size_t i = 0;
+        for (const auto &config : lazy) {
+            EXPECT_EQ(config.phi_1, configs[i].phi_1);
+            EXPECT_EQ(config.phi_2, configs[i].phi_2);
+            EXPECT_EQ(config.phi_3, configs[i].phi_3);
+            EXPECT_EQ(su.forward(config), frame);
+            i++;
+        }
+    }
+}
+
+TEST(Mechanism, Verified_Inverse) { // NOLINT
+    UnitLine a(
+            DirectionVector(1,0,1).normal(),
+            PointVector(0,0,0)
+    );
+
+    UnitLine b(
+            DirectionVector(0,1,0).normal(),
+            PointVector(1,0,0)
+    );
+
+    UnitLine c(
+            DirectionVector(1,0,0).normal(),
+            PointVector(0,-4,1)
+    );
+
+    DualFrame zp(
+            RotationMatrix(1 * M_PI_4, -1 * M_PI_4, 3 * M_PI_4),
+            PointVector(-2,0,4)
+    );
+
+    CCCMechanism orthogonal(a, b, c, zp);
+
+    std::vector<Configuration> configs = {
+            {0.3 + 1_s, -0.5 + 2_s, 1.2 - 1_s},
+            {-2 + 0_s, 1 - 3_s, 0.1 + 0.5_s}
+    };
+
+    for (const auto &config : configs) {
+        auto frame = orthogonal.forward(config);
+        auto verified = orthogonal.inverse_verified(frame);
+        ASSERT_FALSE(verified.empty());
+
+        for (const auto &solution : verified) {
+            EXPECT_EQ(orthogonal.forward(solution.configuration), frame);
+            EXPECT_NEAR(solution.residual.real(), 0, 1e-6);
+            EXPECT_NEAR(solution.residual.dual(), 0, 1e-6);
+        }
+    }
+
+    // Perturbed solutions have a known error
+    auto frame = orthogonal.forward(configs[0]);
+    auto solutions = orthogonal.inverse_lazy(frame);
+    auto solution = solutions[0];
+
+    // A pure translation along the first line moves the endeffector by exactly its length
+    auto shifted = solutions.verify({solution.phi_1 + 0.2_s, solution.phi_2, solution.phi_3});
+    EXPECT_NEAR(shifted.residual.real(), 0, 1e-9);
+    EXPECT_NEAR(shifted.residual.dual(), 0.2, 1e-9);
+
+    // A pure rotation of the third joint rotates the endeffector by its angle
+    Configuration rotated_config = {solution.phi_1, solution.phi_2, solution.phi_3 + 0.1};
+    auto rotated = solutions.verify(rotated_config);
+    EXPECT_NEAR(rotated.residual.real(), 0.1, 1e-9);
+    EXPECT_NEAR(rotated.residual.dual(), (orthogonal.forward(rotated_config).p() - frame.p()).norm(), 1e-9);
+    EXPECT_GT(rotated.residual.dual(), 0.1);
+}
+
+TEST(Mechanism, Refinement) { // NOLINT
+    UnitLine a(
+            DirectionVector(1,0,1).normal(),
+            PointVector(0,0,0)
+    );
+
+    UnitLine b(
+            DirectionVector(0,1,0).normal(),
+            PointVector(1,0,0)
+    );
+
+    UnitLine c(
+            DirectionVector(1,0,0).normal(),
+            PointVector(0,-4,1)
+    );
+
+    DualFrame zp(
+            RotationMatrix(1 * M_PI_4, -1 * M_PI_4, 3 * M_PI_4),
+            PointVector(-2,0,4)
+    );
+
+    CCCMechanism orthogonal(a, b, c, zp);
+
+    Configuration goal = {0.3 + 1_s, -0.5 + 2_s, 1.2 - 1_s};
+    Configuration seed = {0.35 + 0.9_s, -0.45 + 2.1_s, 1.1 - 1.05_s};
+    auto frame = orthogonal.forward(goal);
+
+    auto refined = orthogonal.refine(frame, seed);
+    EXPECT_EQ(refined.state, RefinementState::CONVERGED);
+    EXPECT_GT(refined.iterations, 0u);
+    EXPECT_LE(refined.iterations, 10u);
+    EXPECT_EQ(orthogonal.forward(refined.configuration), frame);
+
+    // An already exact seed needs no step at all
+    auto exact = orthogonal.refine(frame, goal);
+    EXPECT_EQ(exact.state, RefinementState::CONVERGED);
+    EXPECT_EQ(exact.iterations, 0u);
+
+    auto solutions = orthogonal.inverse_refined(frame, seed);
+    ASSERT_FALSE(solutions.empty());
+    for (const auto &solution : solutions) {
+        EXPECT_EQ(solution.state, RefinementState::CONVERGED);
+        EXPECT_EQ(orthogonal.forward(solution.configuration), frame);
+    }
+
+    // The iteration bound is respected
+    auto bounded = orthogonal.refine(frame, seed, 1, 0);
+    EXPECT_LE(bounded.iterations, 1u);
+    EXPECT_NE(bounded.state, RefinementState::CONVERGED);
+
+    auto limited = orthogonal.refine(frame, seed, 1);
+    EXPECT_EQ(limited.state, RefinementState::MAX_ITERATIONS);
+    EXPECT_EQ(limited.iterations, 1u);
+
+    // Without tolerance the steps only stop when rounding prevents any decrease
+    auto stalled = orthogonal.refine(frame, seed, 100, 0);
+    EXPECT_EQ(stalled.state, RefinementState::STALLED);
+    EXPECT_EQ(orthogonal.forward(stalled.configuration), frame);
+}
+
+TEST(Mechanism, Refinement_Singular) { // NOLINT
+    // Parallel first and final third line
+    UnitLine a(
+            DirectionVector(1,0,1).normal(),
+            PointVector(0,0,0)
+    );
+
+    UnitLine b(
+            DirectionVector(0,1,0).normal(),
+            PointVector(1,0,0)
+    );
+
+    UnitLine c(
+            DirectionVector(1,0,0).normal(),
+            PointVector(0,-4,1)
+    );
+
+    DualFrame zp(
+            RotationMatrix(1 * M_PI_4, -1 * M_PI_4, 3 * M_PI_4),
+            PointVector(-2,0,4)
+    );
+
+    CCCMechanism orthogonal(a, b, c, zp);
+
+    // Both parallel solutions coincide, thus the length of the dual offset is zero up to rounding
+    Configuration parallel = {1 + 1_s, DualNumber(-M_PI_4, 4), 1.2 - 1_s};
+    Configuration parallel_seed = {1.05 + 0.9_s, DualNumber(-M_PI_4 + 0.05, 4.1), 1.1 - 1.05_s};
+    auto parallel_frame = orthogonal.forward(parallel);
+
+    for (const auto &solution : orthogonal.inverse_lazy(parallel_frame)) {
+        EXPECT_TRUE(std::isfinite(solution.phi_1.real()));
+        EXPECT_TRUE(std::isfinite(solution.phi_2.dual()));
+        EXPECT_EQ(orthogonal.forward(solution), parallel_frame);
+    }
+
+    auto refined = orthogonal.inverse_refined(parallel_frame, parallel_seed);
+    ASSERT_FALSE(refined.empty());
+    for (const auto &solution : refined) {
+        EXPECT_EQ(solution.state, RefinementState::CONVERGED);
+        EXPECT_EQ(orthogonal.forward(solution.configuration), parallel_frame);
+    }
+
+    // Moving the pose towards the first line yields a negative length and thus invalid analytic solutions
+    // The seed replaces them and the refinement reaches the pose up to the shift
+    DualFrame shift(RotationMatrix(0, 0, 0), PointVector(1e-6 * M_SQRT1_2, 0, -1e-6 * M_SQRT1_2));
+    auto shifted_frame = shift * parallel_frame;
+
+    auto invalid = orthogonal.inverse_lazy(shifted_frame);
+    ASSERT_FALSE(invalid.empty());
+    EXPECT_FALSE(std::isfinite(invalid[0].phi_2.dual()));
+
+    refined = orthogonal.inverse_refined(shifted_frame, parallel_seed, 10, 1e-5);
+    ASSERT_FALSE(refined.empty());
+    for (const auto &solution : refined) {
+        EXPECT_EQ(solution.state, RefinementState::CONVERGED);
+        auto reached = orthogonal.forward(solution.configuration);
+        EXPECT_LT((reached.p() - shifted_frame.p()).norm(), 1e-5);
+        EXPECT_LT((reached.R().get() - shifted_frame.R().get()).norm(), 1e-5);
+    }
+
+    // The angle between the first and the final third line is at its maximum
+    UnitLine z(
+            DirectionVector(0,0,1).normal(),
+            PointVector(0,0,0)
+    );
+
+    UnitLine tilted(
+            DirectionVector(0,1,1).normal(),
+            PointVector(1,0,0)
+    );
+
+    CCCMechanism boundary(z, tilted, c, zp);
+
+    // phi_2 = atan2(b, a) of the trigonometric equation, thus the discriminant is zero
+    Configuration extremal = {0.3 + 1_s, DualNumber(-M_PI_2, 2), 1.2 - 1_s};
+    Configuration extremal_seed = {0.35 + 0.9_s, DualNumber(-M_PI_2 + 0.05, 2.1), 1.1 - 1.05_s};
+    auto extremal_frame = boundary.forward(extremal);
+
+    EXPECT_EQ(boundary.inverse_lazy(extremal_frame).size(), 1u);
+    refined = boundary.inverse_refined(extremal_frame, extremal_seed);
+    ASSERT_EQ(refined.size(), 1u);
+    EXPECT_EQ(refined[0].state, RefinementState::CONVERGED);
+    EXPECT_EQ(boundary.forward(refined[0].configuration), extremal_frame);
+
+    // Turning the pose slightly beyond the maximum angle makes the discriminant slightly negative
+    // The analytic solution fails and the seed is refined instead
+    Eigen::Matrix<double, 3, 1> n3 = (extremal_frame * zp.inverse() * c).n().get();
+    Eigen::Matrix<double, 3, 1> axis = z.n().get().cross(n3);
+    UnitLine turn_axis(
+            DirectionVector(axis(0), axis(1), axis(2)).normal(),
+            PointVector(0,0,0)
+    );
+    auto turned_frame = DualFrame(DualSkewProduct(turn_axis, -1e-6)) * extremal_frame;
+
+    EXPECT_THROW(boundary.inverse_lazy(turned_frame), std::domain_error);
+    refined = boundary.inverse_refined(turned_frame, extremal_seed, 10, 1e-5);
+    ASSERT_EQ(refined.size(), 1u);
+    EXPECT_EQ(refined[0].state, RefinementState::CONVERGED);
+    auto reached = boundary.forward(refined[0].configuration);
+    EXPECT_LT((reached.p() - turned_frame.p()).norm(), 1e-5);
+    EXPECT_LT((reached.R().get() - turned_frame.R().get()).norm(), 1e-5);
+}
+
+TEST(Mechanism, Line_Chain) { // NOLINT
+    UnitLine a(
+            DirectionVector(1,0,1).normal(),
+            PointVector(0,0,0)
+    );
+
+    UnitLine b(
+            DirectionVector(0,1,0).normal(),
+            PointVector(1,0,0)
+    );
+
+    UnitLine c(
+            DirectionVector(1,0,0).normal(),
+            PointVector(0,-4,1)
+    );
+
+    DualFrame zp(
+            RotationMatrix(1 * M_PI_4, -1 * M_PI_4, 3 * M_PI_4),
+            PointVector(-2,0,4)
+    );
+
+    CCCMechanism ccc(a, b, c, zp);
+    LineChain<3> chain({a, b, c}, zp);
+
+    Configuration config = {0.3 + 1_s, -0.5 + 2_s, 1.2 - 1_s};
+    LineChain<3>::Values values = {config.phi_1, config.phi_2, config.phi_3};
+
+    EXPECT_EQ(chain.forward(values), ccc.forward(config));
+
+    auto verbose = ccc.forward_verbose(config);
+    auto chain_verbose = chain.forward_verbose(values);
+    EXPECT_EQ(chain_verbose.first, std::get<0>(verbose));
+    EXPECT_EQ(chain_verbose.second[0], a);
+    EXPECT_EQ(chain_verbose.second[1], std::get<1>(verbose));
+    EXPECT_EQ(chain_verbose.second[2], std::get<2>(verbose));
+
+    EXPECT_TRUE(chain.jacobian(values).isApprox(ccc.jacobian(config)));
+
+    // A six joint chain is just the longer product
+    LineChain<6> arm({a, b, c, b, a, c}, zp);
+    LineChain<6>::Values arm_values = {0.1 + 0_s, -0.2 + 0_s, 0.3_s, 0.4 + 0_s, -0.5 + 1_s, 0.6 + 0_s};
+
+    DualFrame expected = DualFrame(DualSkewProduct(a, arm_values[0])) *
+                         DualFrame(DualSkewProduct(b, arm_values[1])) *
+                         DualFrame(DualSkewProduct(c, arm_values[2])) *
+                         DualFrame(DualSkewProduct(b, arm_values[3])) *
+                         DualFrame(DualSkewProduct(a, arm_values[4])) *
+                         DualFrame(DualSkewProduct(c, arm_values[5])) *
+                         zp;
+    EXPECT_EQ(arm.forward(arm_values), expected);
+    EXPECT_EQ(arm.forward_verbose(arm_values).first, expected);
+}
+
+TEST(Mechanism, Locked_Joints) { // NOLINT
+    UnitLine a(
+            DirectionVector(1,0,1).normal(),
+            PointVector(0,0,0)
+    );
+
+    UnitLine b(
+            DirectionVector(0,1,0).normal(),
+            PointVector(1,0,0)
+    );
+
+    UnitLine c(
+            DirectionVector(1,0,0).normal(),
+            PointVector(0,-4,1)
+    );
+
+    DualFrame zp(
+            RotationMatrix(1 * M_PI_4, -1 * M_PI_4, 3 * M_PI_4),
+            PointVector(-2,0,4)
+    );
+
+    CCCMechanism mechanism(a, b, c, zp);
+
+    // RCC
+    Configuration rcc = {0.3 + 0_s, -0.5 + 2_s, 1.2 - 1_s};
+    auto frame = mechanism.forward(rcc);
+    auto solutions = mechanism.inverse(frame, {JointType::REVOLUTE, JointType::CYLINDRICAL, JointType::CYLINDRICAL});
+    ASSERT_FALSE(solutions.empty());
+    for (const auto &solution : solutions) {
+        EXPECT_EQ(solution.phi_1.dual(), 0);
+        EXPECT_EQ(mechanism.forward(solution), frame);
+    }
+
+    // CPC
+    Configuration cpc = {0.3 + 1_s, 2_s, 1.2 - 1_s};
+    frame = mechanism.forward(cpc);
+    solutions = mechanism.inverse(frame, {JointType::CYLINDRICAL, JointType::PRISMATIC, JointType::CYLINDRICAL});
+    ASSERT_FALSE(solutions.empty());
+    for (const auto &solution : solutions) {
+        EXPECT_EQ(solution.phi_2.real(), 0);
+        EXPECT_EQ(mechanism.forward(solution), frame);
+    }
+
+    // A pose outside of the RRR workspace
+    EXPECT_TRUE(mechanism.inverse(frame, {JointType::REVOLUTE, JointType::REVOLUTE, JointType::REVOLUTE}).empty());
+
+    // CRC
+    Configuration crc = {0.3 + 1_s, -0.5 + 0_s, 1.2 - 1_s};
+    frame = mechanism.forward(crc);
+    solutions = mechanism.inverse(frame, {JointType::CYLINDRICAL, JointType::REVOLUTE, JointType::CYLINDRICAL});
+    ASSERT_FALSE(solutions.empty());
+    for (const auto &solution : solutions) {
+        EXPECT_EQ(solution.phi_2.dual(), 0);
+        EXPECT_EQ(mechanism.forward(solution), frame);
+    }
+
+    // A noisy pose still yields the closest locked configuration
+    DualFrame noise(RotationMatrix(2e-8, -1e-8, 3e-8), PointVector(-2e-8, 1e-8, 2e-8));
+    auto noisy = noise * mechanism.forward(rcc);
+    EXPECT_FALSE(mechanism.inverse(noisy, {JointType::REVOLUTE, JointType::CYLINDRICAL, JointType::CYLINDRICAL}).empty());
+    EXPECT_TRUE(mechanism.inverse(noisy, {JointType::REVOLUTE, JointType::CYLINDRICAL, JointType::CYLINDRICAL}, 1e-9).empty());
+
+    // The first and the third line of the SU mechanism coincide for phi_2 = 0
+    // The CCC solution puts the whole motion into the first joint, the locks require to split it
+    CCCMechanism su = create_SU();
+    Configuration pcr = {0 + 2_s, 0 + 0_s, 0.7 + 0_s};
+    frame = su.forward(pcr);
+    solutions = su.inverse(frame, {JointType::PRISMATIC, JointType::CYLINDRICAL, JointType::REVOLUTE});
+    ASSERT_FALSE(solutions.empty());
+    for (const auto &solution : solutions) {
+        EXPECT_EQ(solution.phi_1.real(), 0);
+        EXPECT_EQ(solution.phi_3.dual(), 0);
+        EXPECT_EQ(su.forward(solution), frame);
+    }
+
+    // A translation along the second line makes them parallel and only the translations can be exchanged
+    Configuration rcp = {0.4 + 0_s, 0 + 1_s, 0 + 1.5_s};
+    frame = su.forward(rcp);
+    solutions = su.inverse(frame, {JointType::REVOLUTE, JointType::CYLINDRICAL, JointType::PRISMATIC});
+    ASSERT_FALSE(solutions.empty());
+    for (const auto &solution : solutions) {
+        EXPECT_EQ(solution.phi_1.dual(), 0);
+        EXPECT_EQ(solution.phi_3.real(), 0);
+        EXPECT_EQ(su.forward(solution), frame);
+    }
+
+    Configuration pcr_parallel = {0 + 2_s, 0 + 1_s, 0.6 + 0_s};
+    frame = su.forward(pcr_parallel);
+    solutions = su.inverse(frame, {JointType::PRISMATIC, JointType::CYLINDRICAL, JointType::REVOLUTE});
+    ASSERT_FALSE(solutions.empty());
+    for (const auto &solution : solutions) {
+        EXPECT_EQ(solution.phi_1.real(), 0);
+        EXPECT_EQ(solution.phi_3.dual(), 0);
+        EXPECT_EQ(su.forward(solution), frame);
+    }
+
+    // RRR orientation
+    Configuration rrr = {0.3 + 0_s, -0.5 + 0_s, 1.2 + 0_s};
+    auto orientation = mechanism.forward(rrr).R();
+    auto wrist = mechanism.inverse_orientation(orientation);
+    ASSERT_FALSE(wrist.empty());
+    for (const auto &solution : wrist) {
+        EXPECT_EQ(solution.phi_1.dual(), 0);
+        EXPECT_EQ(solution.phi_2.dual(), 0);
+        EXPECT_EQ(solution.phi_3.dual(), 0);
+        EXPECT_TRUE(mechanism.forward(solution).R().get().isApprox(orientation.get(), 1e-7));
+    }
+}
+
+TEST(Mechanism, Structured_Forward) { // NOLINT
+    CCCMechanism su = create_SU();
+    StructuredCCCMechanism<AXIS_Z, AXIS_X, AXIS_Z> structured_su(su);
+
+    UnitLine a(
+            DirectionVector(1,0,1).normal(),
+            PointVector(0,0,0)
+    );
+
+    UnitLine b(
+            DirectionVector(0,1,0).normal(),
+            PointVector(1,0,0)
+    );
+
+    UnitLine c(
+            DirectionVector(1,0,0).normal(),
+            PointVector(0,-4,1)
+    );
+
+    DualFrame zp(
+            RotationMatrix(1 * M_PI_4, -1 * M_PI_4, 3 * M_PI_4),
+            PointVector(-2,0,4)
+    );
+
+    CCCMechanism orthogonal(a, b, c, zp);
+    StructuredCCCMechanism<AXIS_ANY, AXIS_Y, AXIS_X> structured_orthogonal(a, b, c, zp);
+
+    std::vector<Configuration> configs = {
+            {0 + 0_s, 0 + 0_s, 0 + 0_s},
+            {0.3 + 1_s, -0.5 + 2_s, 1.2 - 1_s},
+            {-2 + 0_s, 1 - 3_s, 0.1 + 0.5_s},
+            {M_PI + 4_s, -M_PI_2 + 0_s, 3 - 2_s}
+    };
+
+    for (const auto &config : configs) {
+        EXPECT_EQ(structured_su.forward(config), su.forward(config));
+        EXPECT_EQ(structured_orthogonal.forward(config), orthogonal.forward(config));
+
+        auto frame = structured_orthogonal.forward(config);
+        for (const auto &solution : structured_orthogonal.inverse(frame)) {
+            EXPECT_EQ(structured_orthogonal.forward(solution), frame);
+        }
+    }
+
+    // The declared structure has to match the lines
+    using WrongStructure = StructuredCCCMechanism<AXIS_X, AXIS_X, AXIS_Z>;
+    EXPECT_THROW(WrongStructure{su}, std::invalid_argument);
+}
+
+TEST(Mechanism, Plain_Data) { // NOLINT
+    UnitLine line(PointVector(1, 2, 3), PointVector(-1, 0, 2));
+    DualFrame frame(RotationMatrix(0.4, -0.3, 1.2), PointVector(3, -2, 1));
+    Configuration configuration = {DualNumber(0.1, 2), DualNumber(-1, 0.5), DualNumber(2, -3)};
+
+    // Copy through raw bytes as it would be done with a file
+    std::vector<LineData> lines(3);
+    auto stored = to_data(line);
+    std::memcpy(&lines[1], &stored, sizeof(LineData));
+    EXPECT_EQ(to_line(lines[1]), line);
+
+    EXPECT_EQ(to_frame(to_data(frame)), frame);
+
+    auto restored = to_configuration(to_data(configuration));
+    EXPECT_EQ(restored.phi_1, configuration.phi_1);
+    EXPECT_EQ(restored.phi_2, configuration.phi_2);
+    EXPECT_EQ(restored.phi_3, configuration.phi_3);
+
+    // The view works with the batch functions in place
+    transform_lines(frame, view(lines.data(), lines.size()), view(lines.data(), lines.size()));
+    EXPECT_EQ(to_line(lines[1]), frame * line);
+}
+
+TEST(Mechanism, Homogeneous_Interop) { // NOLINT
+    DualFrame frame(RotationMatrix(0.3, -0.7, 1.1), PointVector(1, -2, 3));
+
+    // Round trips through all representations
+    EXPECT_EQ(DualFrame(frame.isometry()), frame);
+    EXPECT_EQ(DualFrame::FromHomogeneous(frame.homogeneous()), frame);
+    Eigen::Quaterniond q(frame.R().get());
+    EXPECT_EQ(DualFrame(Eigen::Quaterniond(2 * q.coeffs()), frame.p().get()), frame);
+
+    double row_major[16];
+    frame.homogeneous(row_major);
+    EXPECT_DOUBLE_EQ(row_major[3], 1);
+    EXPECT_DOUBLE_EQ(row_major[15], 1);
+    EXPECT_EQ(DualFrame::FromHomogeneous(row_major, unchecked), frame);
+
+    Eigen::Matrix4d scaled = 2 * Eigen::Matrix4d::Identity();
+    EXPECT_THROW(DualFrame::FromHomogeneous(scaled), std::domain_error);
+
+    // Kinematics directly on the buffers
+    CCCMechanism mechanism(
+            UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+            UnitLine(PointVector(0, 1, 0), PointVector(1, 1, 1)),
+            UnitLine(PointVector(1, 0, 2), PointVector(1, 2, 2)),
+            DualFrame(RotationMatrix(0, 0, 0), PointVector(1, 2, 3)));
+    Configuration configuration = {DualNumber(0.5, 1), DualNumber(-0.3, 0.2), DualNumber(1.2, -1)};
+
+    mechanism.forward(configuration, row_major);
+    auto pose = mechanism.forward(configuration);
+    EXPECT_EQ(DualFrame::FromHomogeneous(row_major, unchecked), pose);
+
+    auto solutions = mechanism.inverse(row_major);
+    auto isometry_solutions = mechanism.inverse(pose.isometry());
+    ASSERT_FALSE(solutions.empty());
+    ASSERT_EQ(solutions.size(), isometry_solutions.size());
+    for (std::size_t i = 0; i < solutions.size(); i++) {
+        EXPECT_EQ(mechanism.forward(solutions[i]), pose);
+        EXPECT_EQ(mechanism.forward(isometry_solutions[i]), pose);
+    }
+}
+
+TEST(Mechanism, Forward_Cache) { // NOLINT
+    CCCMechanism mechanism(
+            UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+            UnitLine(PointVector(0, 1, 0), PointVector(1, 1, 1)),
+            UnitLine(PointVector(1, 0, 2), PointVector(1, 2, 2)),
+            DualFrame(RotationMatrix(0.4, -0.2, 0.1), PointVector(1, 2, 3)));
+    Configuration configuration = {DualNumber(0.5, 1), DualNumber(-0.3, 0.2), DualNumber(1.2, -1)};
+
+    auto check = [&mechanism](const ForwardCache &cache) {
+        auto verbose = mechanism.forward_verbose(cache.configuration());
+        EXPECT_EQ(cache.pose(), std::get<0>(verbose));
+        EXPECT_EQ(cache.second_line(), std::get<1>(verbose));
+        EXPECT_EQ(cache.third_line(), std::get<2>(verbose));
+    };
+
+    ForwardCache cache(mechanism, configuration);
+    check(cache);
+
+    cache.set_phi_3(DualNumber(-2, 0.5));
+    check(cache);
+    cache.set_phi_2(DualNumber(1, -1));
+    check(cache);
+    cache.set_phi_1(DualNumber(3, 2));
+    check(cache);
+
+    configuration.phi_2 = DualNumber(0.7, 0.1);
+    cache.update(configuration);
+    check(cache);
+    EXPECT_EQ(cache.configuration().phi_1, configuration.phi_1);
+}
+
+TEST(Mechanism, Axis_Identification) { // NOLINT
+    CCCMechanism mechanism(
+            UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+            UnitLine(PointVector(0, 1, 0), PointVector(1, 1, 1)),
+            UnitLine(PointVector(1, 0, 2), PointVector(1, 2, 2)),
+            DualFrame(RotationMatrix(0.4, -0.2, 0.1), PointVector(1, 2, 3)));
+    Configuration configuration = {DualNumber(0.5, 1), DualNumber(-0.3, 0.2), DualNumber(0, 0)};
+    auto axis = std::get<2>(mechanism.forward_verbose(configuration));
+
+    // Only the third joint moves, the measurements are slightly noisy and some are wrong
+    std::mt19937 generator(7);
+    std::normal_distribution<double> noise(0, 1e-4);
+    std::vector<DualFrame> poses;
+    for (int i = 0; i < 2000; i++) {
+        configuration.phi_3 = DualNumber(-2.5 + 5.0 * i / 2000, 0.3 * std::sin(i));
+        DualFrame error(RotationMatrix(noise(generator), noise(generator), noise(generator)),
+                        PointVector(noise(generator), noise(generator), noise(generator)));
+        poses.push_back(i % 100 == 50 ? Random::SampleFrame() : error * mechanism.forward(configuration));
+    }
+
+    configuration.phi_3 = DualNumber(0, 0);
+    AxisIdentifier identifier(mechanism.forward(configuration));
+    EXPECT_FALSE(identifier.add(mechanism.forward(configuration)));
+    auto used = identifier.add(poses);
+    EXPECT_EQ(used, identifier.size());
+    EXPECT_GT(used, 1900u);
+
+    // Measured axes of negative motions have the opposite orientation, so the orientation is not compared
+    auto error = [&axis](const UnitLine &line) {
+        return 1 - std::abs(line.n() * axis.n()) + axis.get_distance(line.get_canonical_anchor());
+    };
+    EXPECT_LT(error(identifier.fit(1e-2, 20)), 1e-3);
+    EXPECT_LT(error(identifier.fit(1e-2, 20)), error(identifier.fit()));
+
+    EXPECT_THROW(AxisIdentifier(poses[0]).fit(), std::domain_error); // NOLINT
+}
+
+TEST(Mechanism, Calibration) { // NOLINT
+    CCCMechanism robot(
+            UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+            UnitLine(PointVector(0, 1, 0), PointVector(1, 1, 1)),
+            UnitLine(PointVector(1, 0, 2), PointVector(1, 2, 2)),
+            DualFrame(RotationMatrix(0.4, -0.2, 0.1), PointVector(1, 2, 3)));
+
+    // The nominal model deviates from the real robot
+    auto drift = [](double z, double y, double x, double px, double py, double pz) {
+        return DualFrame(RotationMatrix(z, y, x), PointVector(px, py, pz));
+    };
+    CCCMechanism nominal(
+            drift(0.01, -0.02, 0.01, 0.01, 0, -0.02) * robot.l12,
+            drift(-0.02, 0.01, 0.03, 0.02, -0.01, 0) * robot.l23,
+            drift(0.01, 0.01, -0.02, 0, 0.03, 0.01) * robot.l34,
+            drift(0.02, 0, -0.01, 0.01, 0.02, -0.03) * robot.zero_posture);
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<double> distance(-0.5, 0.5);
+    auto sample_configuration = [&]() {
+        return Configuration{DualNumber(angle(generator), distance(generator)),
+                             DualNumber(angle(generator), distance(generator)),
+                             DualNumber(angle(generator), distance(generator))};
+    };
+    std::vector<CalibrationSample> samples;
+    for (int i = 0; i < 1000; i++) {
+        auto configuration = sample_configuration();
+        samples.push_back({configuration, robot.forward(configuration)});
+    }
+
+    auto result = calibrate(nominal, samples, 50, 4);
+    EXPECT_EQ(result.state, RefinementState::CONVERGED);
+    EXPECT_LT(result.error, 1e-9);
+    EXPECT_EQ(result.mechanism.l12, robot.l12);
+    EXPECT_EQ(result.mechanism.l23, robot.l23);
+    EXPECT_EQ(result.mechanism.l34, robot.l34);
+    EXPECT_EQ(result.mechanism.zero_posture, robot.zero_posture);
+
+    // The calibrated mechanism predicts unseen poses
+    for (int i = 0; i < 10; i++) {
+        auto configuration = sample_configuration();
+        EXPECT_EQ(result.mechanism.forward(configuration), robot.forward(configuration));
+    }
+
+    // Neither the iteration limit nor a hopeless calibration are reported as converged
+    EXPECT_EQ(calibrate(nominal, samples, 1).state, RefinementState::MAX_ITERATIONS);
+    std::vector<CalibrationSample> broken(samples.begin(), samples.begin() + 10);
+    broken[3].pose = DualFrame(RotationMatrix(0, 0, 0), PointVector(std::numeric_limits<double>::quiet_NaN(), 0, 0));
+    EXPECT_EQ(calibrate(nominal, broken).state, RefinementState::STALLED);
+
+    EXPECT_THROW(calibrate(nominal, {samples[0], samples[1]}), std::invalid_argument); // NOLINT
+}
@@ -15,6 +15,14 @@
 #include "dual_frame.h"
 #include "dual_skew.h"
 #include "dual_skew_product.h"
+#include "subproblems.h"
+#include "interpolation.h"
+#include "ray_casting.h"
+#include "line_index.h"
+#include "line_table.h"
+#include "line_fitting.h"
+#include "line_registration.h"
+#include "ccc.h"
 
 #include <gtest/gtest.h>
 
@@ -272,3 +280,735 @@ TEST(Screws, LieAlgebra) { //NOLINT
     //ASSERT_EQ(sum, skew_by_deconstruction);
     //ASSERT_EQ(frame_by_sum, a_by_line * b_by_line);
 }
+
+TEST(Screws, Subproblems) { //NOLINT
+    UnitLine axis(
+            DirectionVector(0,1,1).normal(),
+            PointVector(1,0,0)
+    );
+
+    UnitLine second(
+            UnitDirectionVector(1,0,0),
+            PointVector(0,2,1)
+    );
+
+    UnitLine a(
+            DirectionVector(1,2,3).normal(),
+            PointVector(0,-1,2)
+    );
+
+    DualNumber phi(0.7, 1.5);
+    DualNumber psi(-1.1, 0.5);
+
+    // First subproblem
+    auto b = DualFrame(DualSkewProduct(axis, phi)) * a;
+    EXPECT_NEAR_DN(Subproblem::transform_onto(axis, a, b), phi, 0.00001);
+    EXPECT_THROW(Subproblem::transform_onto(axis, a, second), std::domain_error);
+
+    // Second subproblem
+    auto c = DualFrame(DualSkewProduct(axis, phi)) * (DualFrame(DualSkewProduct(second, psi)) * a);
+    auto pairs = Subproblem::transform_onto(axis, second, a, c);
+    ASSERT_FALSE(pairs.empty());
+    auto near = [](const DualNumber &x, const DualNumber &y) {
+        return std::abs(std::remainder(x.real() - y.real(), 2 * M_PI)) < 0.00001 && std::abs(x.dual() - y.dual()) < 0.00001;
+    };
+    bool found = false;
+    for (const auto &pair : pairs) {
+        auto reached = DualFrame(DualSkewProduct(axis, pair.first)) * (DualFrame(DualSkewProduct(second, pair.second)) * a);
+        EXPECT_EQ(reached, c);
+        found |= near(pair.first, phi) && near(pair.second, psi);
+    }
+    EXPECT_TRUE(found);
+
+    // Third subproblem
+    auto distance = b.get_distance(second);
+    auto angles = Subproblem::transform_to_distance(axis, a, second, distance);
+    ASSERT_FALSE(angles.empty());
+    for (const auto &angle : angles) {
+        auto reached = DualFrame(DualSkewProduct(axis, angle)) * a;
+        EXPECT_NEAR_DN(reached.get_distance(second), distance, 0.00001);
+    }
+
+    // Locked joints
+    auto rotated = DualFrame(DualSkewProduct(axis, DualNumber(phi.real(), 0))) * a;
+    EXPECT_TRUE(near(Subproblem::transform_onto(axis, a, rotated, JointType::REVOLUTE), DualNumber(phi.real(), 0)));
+    auto translated = DualFrame(DualSkewProduct(axis, DualNumber(0, phi.dual()))) * a;
+    EXPECT_TRUE(near(Subproblem::transform_onto(axis, a, translated, JointType::PRISMATIC), DualNumber(0, phi.dual())));
+    EXPECT_TRUE(near(Subproblem::transform_onto(axis, a, b, JointType::CYLINDRICAL), phi));
+
+    distance = rotated.get_distance(second);
+    angles = Subproblem::transform_to_distance(axis, a, second, distance, JointType::REVOLUTE);
+    ASSERT_FALSE(angles.empty());
+    found = false;
+    for (const auto &angle : angles) {
+        EXPECT_EQ(angle.dual(), 0);
+        // A rotation alone only reaches the angle, the translational distance is left to other joints
+        auto reached = DualFrame(DualSkewProduct(axis, angle)) * a;
+        EXPECT_NEAR(reached.get_distance(second).real(), distance.real(), 0.00001);
+        found |= near(angle, DualNumber(phi.real(), 0));
+    }
+    EXPECT_TRUE(found);
+
+    distance = translated.get_distance(second);
+    angles = Subproblem::transform_to_distance(axis, a, second, distance, JointType::PRISMATIC);
+    ASSERT_EQ(angles.size(), 1u);
+    EXPECT_TRUE(near(angles[0], DualNumber(0, phi.dual())));
+
+    // A translation along the axis does not change the distance to a parallel line
+    EXPECT_THROW(Subproblem::transform_to_distance(axis, a, axis.parallel_through_anchor(PointVector(0,3,0)),
+                                                   distance, JointType::PRISMATIC), std::domain_error);
+}
+
+TEST(Screws, Adjoint) { //NOLINT
+    UnitLine line_a(
+            UnitDirectionVector(0,0,1),
+            PointVector(1,0,0)
+    );
+    UnitLine line_b(
+            DirectionVector(0,1,1).normal(),
+            PointVector(1,0,1)
+    );
+
+    auto screw_a = line_a.transform(DualNumber(M_PI_4, 2.5));
+    auto screw_b = line_b.transform(DualNumber(M_PI_2, 3));
+
+    // The bracket is the commutator of the embedded skews
+    Eigen::Matrix<double, 6, 6> skew_a = DualEmbeddedMatrix(DualNumber(M_PI_4, 2.5)).get() * DualSkew(line_a).get();
+    Eigen::Matrix<double, 6, 6> skew_b = DualEmbeddedMatrix(DualNumber(M_PI_2, 3)).get() * DualSkew(line_b).get();
+    Eigen::Matrix<double, 6, 6> commutator = skew_a * skew_b - skew_b * skew_a;
+
+    auto bracket = screw_a.ad(screw_b);
+    EXPECT_EQ(Vector(SkewMatrix(Matrix3(commutator.topLeftCorner(3,3)))), bracket.n());
+    EXPECT_EQ(Vector(SkewMatrix(Matrix3(commutator.bottomLeftCorner(3,3)))), bracket.m());
+    EXPECT_THROW(line_a.ad(line_a.parallel_through_anchor(PointVector(0,4,0))), std::domain_error);
+
+    // The adjoint of a frame is the transformation by the embedded matrix
+    DualFrame frame(RotationMatrix(0.3, -1.2, 2), PointVector(1, -2, 3));
+    EXPECT_EQ(screw_a.Ad(frame), frame * screw_a);
+    EXPECT_EQ(line_b.Ad(frame), frame * line_b);
+    EXPECT_EQ(screw_a.Ad(frame), frame.embedded() * screw_a);
+
+    // Frames still take part in the embedded matrix arithmetic
+    DualEmbeddedMatrix scale(DualNumber(2, 0.5));
+    EXPECT_TRUE((frame * scale).get().isApprox(frame.get() * scale.get()));
+    EXPECT_TRUE((scale * frame).get().isApprox(scale.get() * frame.get()));
+    EXPECT_TRUE((frame + scale).get().isApprox(frame.get() + scale.get()));
+    EXPECT_TRUE((frame - frame).get().isZero());
+    EXPECT_TRUE((-frame).get().isApprox(-frame.get()));
+
+    // Batch versions
+    ScrewBuffer screws(6, 3);
+    screws << line_a.n().get(), line_b.n().get(), screw_b.n().get(),
+              line_a.m().get(), line_b.m().get(), screw_b.m().get();
+
+    ScrewBuffer transformed(6, 3);
+    Ad(frame, screws, transformed);
+    Eigen::Matrix<double, 6, 3> expected = frame.get() * screws;
+    EXPECT_TRUE(transformed.isApprox(expected));
+
+    // In place
+    Ad(frame, screws, screws);
+    EXPECT_TRUE(screws.isApprox(expected));
+
+    ScrewBuffer brackets(6, 3);
+    ad(screw_a, transformed, brackets);
+    EXPECT_EQ(Vector(brackets.col(2).head<3>()), screw_a.ad(screw_b.Ad(frame)).n());
+    EXPECT_EQ(Vector(brackets.col(2).tail<3>()), screw_a.ad(screw_b.Ad(frame)).m());
+}
+
+TEST(Screws, Logarithm) { //NOLINT
+    UnitLine a(
+            DirectionVector(1,-2,1).normal(),
+            PointVector(1,1,0)
+    );
+
+    // Generic, small, close to a half turn and a half turn
+    std::vector<DualNumber> angles = {
+            DualNumber(1.2, -3),
+            DualNumber(1e-6, 2),
+            DualNumber(M_PI - 1e-9, 1),
+            DualNumber(M_PI, 0.5)
+    };
+
+    for (const auto &angle : angles) {
+        DualFrame frame(DualSkewProduct(a, angle));
+        auto log = frame.constructive_line();
+        EXPECT_EQ(DualFrame(log), frame);
+        EXPECT_EQ(log.skew().screw(), a);
+        EXPECT_NEAR_DN(log.angle(), angle, 0.00001);
+    }
+
+    // Pure translation
+    DualFrame translation(RotationMatrix(0, 0, 0), PointVector(0, 3, 4));
+    auto log = translation.constructive_line();
+    EXPECT_EQ(DualFrame(log), translation);
+    EXPECT_NEAR_DN(log.angle(), 5_s, 0.00001);
+
+    // Identity
+    DualFrame identity(RotationMatrix(0, 0, 0), PointVector(0, 0, 0));
+    EXPECT_EQ(DualFrame(identity.constructive_line()), identity);
+}
+
+TEST(Screws, Interpolation) { //NOLINT
+    DualFrame from(RotationMatrix(0.1, 0.2, 0.3), PointVector(1, 2, 3));
+    DualFrame to(RotationMatrix(-1, 0.5, 2), PointVector(-1, 0, 4));
+    DualFrame last(RotationMatrix(0, 0, 0), PointVector(0, 0, 0));
+
+    EXPECT_EQ(sclerp(from, to, 0), from);
+    EXPECT_EQ(sclerp(from, to, 1), to);
+
+    ScrewInterpolator interpolator({from, to, last}, 8);
+    std::vector<DualFrame> frames;
+    while (interpolator.has_next()) {
+        frames.push_back(interpolator.next());
+    }
+
+    ASSERT_EQ(frames.size(), 16u);
+    for (unsigned int i = 0; i < 8; i++) {
+        EXPECT_EQ(frames[i], sclerp(from, to, (i + 1) / 8.0));
+        EXPECT_EQ(frames[i + 8], sclerp(to, last, (i + 1) / 8.0));
+    }
+
+    EXPECT_THROW(ScrewInterpolator(from, to, 0), std::invalid_argument);
+}
+
+TEST(Screws, Batch_Transform) { //NOLINT
+    DualFrame frame(RotationMatrix(0.3, -1.2, 2.1), PointVector(1, -2, 0.5));
+    const Eigen::Index count = 10000;
+
+    ScrewBuffer lines(6, count);
+    PointBuffer points = PointBuffer::Random(3, count);
+    for (Eigen::Index i = 0; i < count; i++) {
+        UnitLine line(DirectionVector(Vector(points.col(i))).normal(), PointVector(i * 0.001, 1, -1));
+        lines.col(i) << line.n().get(), line.m().get();
+    }
+
+    ScrewBuffer transformed_lines(6, count);
+    transform_lines(frame, lines, transformed_lines, 4);
+    PointBuffer transformed_points(3, count);
+    transform_points(frame, points, transformed_points, 4);
+    PointBuffer transformed_directions = points;
+    transform_directions(frame, transformed_directions.data(), transformed_directions.data(), count);
+
+    Eigen::Matrix<double, 3, 3> R = frame.R().get();
+    Eigen::Matrix<double, 3, 1> p = frame.p().get();
+    for (Eigen::Index i = 0; i < count; i += 97) {
+        UnitLine line(DirectionVector(Vector(lines.col(i).head<3>())).normal(), PointVector(i * 0.001, 1, -1));
+        auto expected = frame * line;
+        EXPECT_TRUE(transformed_lines.col(i).head<3>().isApprox(expected.n().get(), 1e-9));
+        EXPECT_TRUE(transformed_lines.col(i).tail<3>().isApprox(expected.m().get(), 1e-9));
+        EXPECT_TRUE(transformed_points.col(i).isApprox(R * points.col(i) + p, 1e-9));
+        EXPECT_TRUE(transformed_directions.col(i).isApprox(R * points.col(i), 1e-9));
+    }
+
+    // In place on user memory
+    transform_lines(frame, lines.data(), lines.data(), count, 3);
+    EXPECT_TRUE(lines.isApprox(transformed_lines, 1e-9));
+}
+
+TEST(Screws, Unchecked_Construction) { //NOLINT
+    // The public constructors still check
+    EXPECT_THROW(UnitDirectionVector(Vector(1, 1, 0)), std::invalid_argument);
+    EXPECT_THROW(SkewMatrix(Matrix3(Eigen::Matrix3d::Identity())), std::domain_error);
+    EXPECT_THROW(RotationMatrix::RotationFromEigen(2 * Eigen::Matrix3d::Identity()), std::domain_error);
+
+    // The tagged ones take the value as it is
+    EXPECT_NO_THROW(UnitDirectionVector(Vector(0, 0, 1), unchecked));
+    EXPECT_NO_THROW(RotationMatrix::RotationFromEigen(Eigen::Matrix3d::Identity(), unchecked));
+
+    // Internal read backs skip the checks
+    UnitLine line(PointVector(1, 2, 0), PointVector(1, 0, 3));
+    EXPECT_EQ(DualSkew(line).screw(), line);
+
+    // A pure translation has no direction, only the internal read back accepts it
+    Screw translation(DirectionVector(Vector(0, 0, 0), unchecked), MomentVector(0, 0, 1));
+    EXPECT_THROW(translation.n(), std::invalid_argument);
+    EXPECT_TRUE(translation.n(unchecked).is_zero());
+    EXPECT_ANY_THROW(DirectionVector(Vector(0, 0, 0), unchecked).normal());
+}
+
+TEST(Screws, Ray_Casting) { //NOLINT
+    // A unit square at z = 0 and a smaller one at z = 1
+    PointBuffer vertices(3, 8);
+    vertices << 0, 1, 1, 0, 0.25, 0.75, 0.75, 0.25,
+                0, 0, 1, 1, 0.25, 0.25, 0.75, 0.75,
+                0, 0, 0, 0, 1, 1, 1, 1;
+    TriangleBuffer indices(3, 4);
+    indices << 0, 0, 4, 4,
+               1, 2, 5, 6,
+               2, 3, 6, 7;
+
+    RayCaster triangles(vertices, indices);
+    auto polygons = RayCaster::FromPolygons(vertices, {{0, 1, 2, 3}, {4, 5, 6, 7}});
+    EXPECT_EQ(triangles.size(), 4u);
+    EXPECT_EQ(polygons.size(), 4u);
+    EXPECT_THROW(RayCaster::FromPolygons(vertices, {{0, 1, 2, 8}}), std::invalid_argument); // NOLINT
+    EXPECT_THROW(RayCaster::FromPolygons(vertices, {{0, -1, 2}}), std::invalid_argument); // NOLINT
+    EXPECT_THROW(RayCaster::FromPolygons(vertices, {{0, 1}}), std::invalid_argument); // NOLINT
+    TriangleBuffer outside(3, 1);
+    outside << 0, 1, 8;
+    EXPECT_THROW(RayCaster(vertices, outside), std::invalid_argument); // NOLINT
+
+    // Single rays from above and below
+    PointVector above(0.5, 0.5, 3);
+    auto hit = triangles.cast(UnitLine(above, PointVector(0.5, 0.5, 0)), above);
+    EXPECT_NEAR(hit.distance, 2, 1e-12);
+    EXPECT_TRUE(hit.face == 2 || hit.face == 3);
+
+    PointVector below(0.1, 0.9, -2);
+    hit = polygons.cast(UnitLine(below, PointVector(0.1, 0.9, 0)), below);
+    EXPECT_NEAR(hit.distance, 2, 1e-12);
+    EXPECT_EQ(hit.face, 0);
+
+    // Batch of rays, some missing, some pointing away
+    PointBuffer origins(3, 4);
+    origins << 0.5, 2, 0.9, 0.3,
+               0.5, 2, 0.1, 0.3,
+               -1, -1, 5, 5;
+    PointBuffer directions(3, 4);
+    directions << 0, 0, 0, 0,
+                  0, 0, 0, 0,
+                  1, 1, -1, 1;
+    std::vector<RayHit> hits(4);
+    polygons.cast(origins, directions, hits.data());
+
+    EXPECT_EQ(hits[0].face, 0);
+    EXPECT_NEAR(hits[0].distance, 1, 1e-12);
+    EXPECT_EQ(hits[1].face, -1);
+    EXPECT_EQ(hits[2].face, 0);
+    EXPECT_NEAR(hits[2].distance, 5, 1e-12);
+    EXPECT_EQ(hits[3].face, -1);
+
+    // Many rays on several threads give the same hits as single rays
+    const Eigen::Index count = 1000;
+    PointBuffer many_origins = PointBuffer::Random(3, count);
+    many_origins.row(2).setConstant(2);
+    PointBuffer many_directions = PointBuffer::Random(3, count);
+    many_directions.row(2).setConstant(-1);
+    std::vector<RayHit> many_hits(count);
+    triangles.cast(many_origins, many_directions, many_hits.data(), 4);
+    for (Eigen::Index i = 0; i < count; i += 37) {
+        auto direction = DirectionVector(Vector(many_directions.col(i)));
+        PointVector origin(Vector(many_origins.col(i)));
+        auto single = triangles.cast(UnitLine(direction, origin), origin);
+        EXPECT_EQ(single.face, many_hits[i].face);
+        if (single.face >= 0) {
+            EXPECT_NEAR(single.distance, many_hits[i].distance * direction.norm(), 1e-9);
+        }
+    }
+}
+
+TEST(Screws, Line_Index) { //NOLINT
+    // Segments and their exact distances
+    LineSegment segment(PointVector(0, 0, 0), PointVector(2, 0, 0));
+    EXPECT_NEAR(segment.length(), 2, 1e-12);
+    EXPECT_NEAR(segment.get_distance(PointVector(1, 1, 0)), 1, 1e-12);
+    EXPECT_NEAR(segment.get_distance(PointVector(3, 0, 0)), 1, 1e-12);
+    EXPECT_NEAR(segment.get_distance(UnitLine(PointVector(1, 0, 1), PointVector(1, 1, 1))), 1, 1e-12);
+    EXPECT_NEAR(segment.get_distance(UnitLine(PointVector(4, 0, 1), PointVector(4, 1, 1))), sqrt(5), 1e-12);
+    EXPECT_THROW(LineSegment(UnitLine(PointVector(0, 0, 0), PointVector(1, 0, 0)), 1, 1), std::invalid_argument);
+
+    // Random segments, half bulk built, half inserted
+    std::vector<LineSegment> segments;
+    for (int i = 0; i < 400; i++) {
+        Vector start = Vector(Eigen::Vector3d::Random() * 10);
+        Vector end = Vector(start.get() + Eigen::Vector3d::Random());
+        segments.emplace_back(PointVector(start), PointVector(end));
+    }
+    LineIndex index(std::vector<LineSegment>(segments.begin(), segments.begin() + 200));
+    for (auto it = segments.begin() + 200; it != segments.end(); it++) {
+        index.insert(*it);
+    }
+    EXPECT_EQ(index.size(), segments.size());
+
+    auto brute_force = [&segments](auto query) {
+        std::vector<double> distances;
+        for (const auto &s : segments) {
+            distances.push_back(s.get_distance(query));
+        }
+        std::sort(distances.begin(), distances.end());
+        return distances;
+    };
+
+    // The index finds the same distances as a linear scan
+    std::vector<PointVector> points;
+    std::vector<UnitLine> lines;
+    for (int i = 0; i < 50; i++) {
+        points.emplace_back(Vector(Eigen::Vector3d::Random() * 10));
+        lines.emplace_back(PointVector(Vector(Eigen::Vector3d::Random() * 10)),
+                           PointVector(Vector(Eigen::Vector3d::Random() * 10)));
+    }
+    auto point_results = index.nearest(points, 5, 4);
+    auto line_results = index.nearest(lines, 5, 4);
+    for (int i = 0; i < 50; i++) {
+        auto expected = brute_force(points[i]);
+        ASSERT_EQ(point_results[i].size(), 5u);
+        for (int j = 0; j < 5; j++) {
+            EXPECT_NEAR(point_results[i][j].distance, expected[j], 1e-9);
+            EXPECT_NEAR(index[point_results[i][j].index].get_distance(points[i]), expected[j], 1e-9);
+        }
+        auto near = index.within(points[i], expected[10]);
+        EXPECT_GE(near.size(), 11u);
+
+        expected = brute_force(lines[i]);
+        ASSERT_EQ(line_results[i].size(), 5u);
+        for (int j = 0; j < 5; j++) {
+            EXPECT_NEAR(line_results[i][j].distance, expected[j], 1e-9);
+        }
+        near = index.within(lines[i], expected[10]);
+        EXPECT_GE(near.size(), 11u);
+        EXPECT_LE(near.back().distance, expected[10]);
+    }
+    EXPECT_TRUE(LineIndex().nearest(points[0], 3).empty());
+}
+
+TEST(Screws, Segment_Distance) { //NOLINT
+    // Crossing, skew, parallel overlapping, parallel apart and collinear segments
+    LineSegment base(PointVector(0, 0, 0), PointVector(2, 0, 0));
+    EXPECT_NEAR(base.get_distance(LineSegment(PointVector(1, -1, 0), PointVector(1, 1, 0))), 0, 1e-12);
+    EXPECT_NEAR(base.get_distance(LineSegment(PointVector(1, -1, 1), PointVector(1, 1, 1))), 1, 1e-12);
+    EXPECT_NEAR(base.get_distance(LineSegment(PointVector(5, -1, 1), PointVector(5, 1, 1))), sqrt(10), 1e-12);
+    EXPECT_NEAR(base.get_distance(LineSegment(PointVector(1, 1, 0), PointVector(3, 1, 0))), 1, 1e-12);
+    EXPECT_NEAR(base.get_distance(LineSegment(PointVector(6, 1, 0), PointVector(4, 1, 0))), sqrt(5), 1e-12);
+    EXPECT_NEAR(base.get_distance(LineSegment(PointVector(-3, 0, 0), PointVector(-1, 0, 0))), 1, 1e-12);
+
+    auto points = base.closest_points(LineSegment(PointVector(3, 1, 0), PointVector(3, 2, 0)));
+    EXPECT_TRUE(points.first == PointVector(2, 0, 0));
+    EXPECT_TRUE(points.second == PointVector(3, 1, 0));
+
+    Capsule capsule(base, 0.5);
+    EXPECT_TRUE(capsule.collides(Capsule(LineSegment(PointVector(1, 0.9, 0), PointVector(1, 2, 0)), 0.5)));
+    EXPECT_FALSE(capsule.collides(Capsule(LineSegment(PointVector(1, 1.1, 0), PointVector(1, 2, 0)), 0.5)));
+    EXPECT_THROW(Capsule(base, -1), std::invalid_argument);
+
+    // The batched kernel agrees with the single segments
+    SegmentBuffer a = SegmentBuffer::Random(6, 7);
+    SegmentBuffer b = SegmentBuffer::Random(6, 150);
+    b.col(3) << a.col(2).tail<3>(), a.col(2).head<3>();
+    b.col(100) << a.col(5).head<3>() + Eigen::Vector3d(0, 0, 0.5), a.col(5).tail<3>() + Eigen::Vector3d(0, 0, 0.5);
+
+    double expected = std::numeric_limits<double>::infinity();
+    for (Eigen::Index i = 0; i < a.cols(); i++) {
+        LineSegment s(PointVector(Vector(a.col(i).head<3>())), PointVector(Vector(a.col(i).tail<3>())));
+        for (Eigen::Index j = 0; j < b.cols(); j++) {
+            LineSegment t(PointVector(Vector(b.col(j).head<3>())), PointVector(Vector(b.col(j).tail<3>())));
+            double distance = s.get_distance(t);
+            expected = std::min(expected, distance);
+            SegmentPair pair = closest_pair(a.col(i), b.col(j));
+            EXPECT_NEAR(pair.distance, distance, 1e-9);
+        }
+    }
+    EXPECT_NEAR(closest_pair(a, b).distance, expected, 1e-9);
+
+    // Early exit at the first pair below the threshold
+    auto pair = closest_pair(a, b, 0.6);
+    EXPECT_LT(pair.distance, 0.6);
+    EXPECT_EQ(closest_pair(a, SegmentBuffer(6, 0)).first, -1);
+
+    // Capsules around the joint lines of a mechanism
+    auto mechanism = CCCMechanism(UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+                                  UnitLine(PointVector(1, 0, 0), PointVector(1, 1, 0)),
+                                  UnitLine(PointVector(1, 0, 1), PointVector(1, 0, 2)),
+                                  DualFrame(RotationMatrix(0, 0, 0), PointVector(0, 0, 3)));
+    auto lines = mechanism.forward_verbose({DualNumber(0.3, 0.2), DualNumber(0.1, 0.4), DualNumber(-0.2, 0.1)});
+    SegmentBuffer links(6, 2);
+    for (int i = 0; i < 2; i++) {
+        const UnitLine &line = i == 0 ? std::get<1>(lines) : std::get<2>(lines);
+        LineSegment link(line, -1, 1);
+        links.col(i) << link.start().get(), link.end().get();
+    }
+    Eigen::VectorXd radii = Eigen::VectorXd::Constant(2, 0.1);
+    auto capsules = closest_pair(links.leftCols(1), radii.head(1), links.rightCols(1), radii.tail(1));
+    EXPECT_NEAR(capsules.distance,
+                LineSegment(std::get<1>(lines), -1, 1).get_distance(LineSegment(std::get<2>(lines), -1, 1)) - 0.2,
+                1e-9);
+}
+
+TEST(Screws, Line_Table) { //NOLINT
+    // All relations, some random lines and enough lines for several tiles
+    UnitLine z(PointVector(0, 0, 0), PointVector(0, 0, 1));
+    std::vector<UnitLine> lines = {
+            z,
+            UnitLine(PointVector(0, 0, 2), PointVector(0, 0, 3)),
+            UnitLine(PointVector(0, 0, 2), PointVector(0, 0, 1)),
+            UnitLine(PointVector(1, 0, 0), PointVector(1, 0, 1)),
+            UnitLine(PointVector(0, 1, 0), PointVector(0, 1, -1)),
+            UnitLine(PointVector(0, 0, 1), PointVector(1, 1, 1)),
+            UnitLine(PointVector(0, 1, 1), PointVector(1, 1, 1))
+    };
+    for (int i = 0; i < 150; i++) {
+        lines.emplace_back(PointVector(Vector(Eigen::Vector3d::Random())), PointVector(Vector(Eigen::Vector3d::Random())));
+    }
+
+    LineTable table(lines, true, 4);
+    LineTable relations_only(lines);
+    ASSERT_EQ(table.size(), static_cast<Eigen::Index>(lines.size()));
+    EXPECT_TRUE(relations_only.angles().size() == 0);
+    EXPECT_THROW(relations_only.distance(0, 1), std::logic_error); // NOLINT
+
+    for (Eigen::Index i = 0; i < table.size(); i++) {
+        for (Eigen::Index j = 0; j < table.size(); j++) {
+            EXPECT_EQ(table.relation(i, j), lines[i].get_relation_to(lines[j]));
+            EXPECT_EQ(relations_only.relation(i, j), table.relation(i, j));
+            auto distance = lines[i].get_distance(lines[j]);
+            EXPECT_NEAR(table.distance(i, j).real(), distance.real(), 1e-7);
+            EXPECT_NEAR(table.distance(i, j).dual(), distance.dual(), 1e-9);
+        }
+    }
+
+    EXPECT_EQ(table.relation(0, 1), COINCIDE);
+    EXPECT_EQ(table.relation(0, 2), ANTI_COINCIDE);
+    EXPECT_EQ(table.relation(0, 3), PARALLEL);
+    EXPECT_EQ(table.relation(0, 4), ANTI_PARALLEL);
+    EXPECT_EQ(table.relation(0, 5), INTERSECT);
+    EXPECT_EQ(table.relation(0, 6), SKEW);
+    EXPECT_FALSE(table.general_position());
+
+    ScrewBuffer skew(6, 3);
+    skew << 0, 1, 0,
+            0, 0, 1,
+            1, 0, 0,
+            0, 0, 0,
+            0, 1, 0,
+            0, -1, 1;
+    EXPECT_TRUE(LineTable(skew).general_position());
+}
+
+TEST(Screws, Acos3_Batch) { //NOLINT
+    UnitLine reference(PointVector(1, 0, 0), PointVector(1, 1, 2));
+    std::vector<UnitLine> a = {
+            reference,
+            -reference,
+            UnitLine(PointVector(0, 0, 0), PointVector(0, 1, 2)),
+            UnitLine(PointVector(3, 0, 0), PointVector(3, 1, 2)),
+            UnitLine(PointVector(1, 0, 0), PointVector(2, 0, 0)),
+    };
+    std::vector<UnitLine> b = {
+            UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+            UnitLine(PointVector(0, 0, 0), PointVector(0, 0, 1)),
+            UnitLine(PointVector(0, 2, 0), PointVector(0, 3, 2)),
+            UnitLine(PointVector(0, 0, 0), PointVector(1, 1, 1)),
+            UnitLine(PointVector(1, 0, 0), PointVector(1, 1, 0)),
+    };
+    for (int i = 0; i < 200; i++) {
+        a.emplace_back(PointVector(Vector(Eigen::Vector3d::Random())), PointVector(Vector(Eigen::Vector3d::Random())));
+        b.emplace_back(PointVector(Vector(Eigen::Vector3d::Random())), PointVector(Vector(Eigen::Vector3d::Random())));
+    }
+
+    const auto count = static_cast<Eigen::Index>(a.size());
+    ScrewBuffer a_buffer(6, count);
+    ScrewBuffer b_buffer(6, count);
+    for (Eigen::Index i = 0; i < count; i++) {
+        a_buffer.col(i) << a[i].n().get(), a[i].m().get();
+        b_buffer.col(i) << b[i].n().get(), b[i].m().get();
+    }
+
+    DualBuffer result(2, count);
+    acos3_batch(reference, a_buffer, b_buffer, result);
+    std::vector<double> plain(2 * count);
+    acos3_batch(reference, a_buffer.data(), b_buffer.data(), plain.data(), a.size());
+
+    for (Eigen::Index i = 0; i < count; i++) {
+        auto expected = reference.acos3(a[i], b[i]);
+        EXPECT_NEAR(result(0, i), expected.real(), 1e-9);
+        EXPECT_NEAR(result(1, i), expected.dual(), 1e-9);
+        EXPECT_EQ(plain[2 * i], result(0, i));
+        EXPECT_EQ(plain[2 * i + 1], result(1, i));
+    }
+
+    // Coinciding lines give no transformation, parallel lines no translation
+    EXPECT_EQ(result(0, 0), 0);
+    EXPECT_EQ(result(1, 1), 0);
+    EXPECT_EQ(result(1, 2), 0);
+    EXPECT_EQ(result(1, 3), 0);
+}
+
+TEST(Screws, Trigonometric_Batch) { //NOLINT
+    using namespace DualNumberAlgebra;
+
+    // Two, one and no solution followed by random equations
+    const Eigen::Index count = 300;
+    DualBuffer a = DualBuffer::Random(2, count);
+    DualBuffer b = DualBuffer::Random(2, count);
+    DualBuffer c = DualBuffer::Random(2, count);
+    a.col(0) << 1, 0.5;
+    b.col(0) << 1, -0.2;
+    c.col(0) << 1, 0.1;
+    a.col(1) << 3, 0.5;
+    b.col(1) << 4, 0.2;
+    c.col(1) << 5, 0.3;
+    a.col(2) << 1, 0;
+    b.col(2) << 1, 0;
+    c.col(2) << 2, 0;
+
+    DualBuffer first(2, count);
+    DualBuffer second(2, count);
+    Eigen::VectorXi counts(count);
+    solve_trigonometric_equations(a, b, c, first, second, counts);
+
+    EXPECT_EQ(counts[0], 2);
+    EXPECT_EQ(counts[1], 1);
+    EXPECT_EQ(counts[2], 0);
+    EXPECT_TRUE(std::isnan(first(0, 2)));
+
+    for (Eigen::Index i = 0; i < count; i++) {
+        std::array<DualNumber, 2> expected;
+        auto found = solve_trigonometric_equation(DualNumber(a(0, i), a(1, i)), DualNumber(b(0, i), b(1, i)),
+                                                  DualNumber(c(0, i), c(1, i)), expected);
+        ASSERT_EQ(counts[i], static_cast<int>(found));
+        if (found == 0) {
+            continue;
+        }
+        EXPECT_NEAR(first(0, i), expected[0].real(), 1e-12);
+        EXPECT_NEAR(first(1, i), expected[0].dual(), 1e-9);
+        if (found == 2) {
+            EXPECT_NEAR(second(0, i), expected[1].real(), 1e-12);
+            EXPECT_NEAR(second(1, i), expected[1].dual(), 1e-9);
+        }
+
+        // Both branches fulfill the equation
+        for (const DualBuffer *solutions : {&first, &second}) {
+            DualNumber phi((*solutions)(0, i), (*solutions)(1, i));
+            auto lhs = DualNumber(a(0, i), a(1, i)) * cos(phi) + DualNumber(b(0, i), b(1, i)) * sin(phi);
+            EXPECT_NEAR(lhs.real(), c(0, i), 1e-6);
+        }
+    }
+}
+
+TEST(Screws, Line_Fitting) { //NOLINT
+    UnitLine first(PointVector(1, 2, 3), PointVector(2, 2, 4));
+    UnitLine second(PointVector(-1, 0, 0), PointVector(-1, 1, 0));
+
+    // Noisy points on both lines and scattered outliers
+    const Eigen::Index count = 3000;
+    PointBuffer points(3, count + 200);
+    for (Eigen::Index i = 0; i < count; i++) {
+        const UnitLine &line = i % 2 == 0 ? first : second;
+        double t = 10.0 * i / count - 5;
+        points.col(i) = (line.get_canonical_anchor() + line.n() * t).get() + 0.01 * Eigen::Vector3d::Random();
+    }
+    points.rightCols(200) = 10 * PointBuffer::Random(3, 200);
+
+    // Streaming, batched, threaded and merged accumulation agree
+    LineFitter single;
+    LineFitter even;
+    for (Eigen::Index i = 0; i < count; i += 2) {
+        single.add(PointVector(Vector(points.col(i))));
+        even.add(PointVector(Vector(points.col(i))));
+    }
+    LineFitter batched;
+    batched.add(points.leftCols(count), 4);
+    LineFitter odd;
+    for (Eigen::Index i = 1; i < count; i += 2) {
+        odd.add(PointVector(Vector(points.col(i))));
+    }
+    odd.merge(even);
+    EXPECT_EQ(batched.size(), static_cast<std::size_t>(count));
+    EXPECT_TRUE(batched.centroid() == odd.centroid());
+    EXPECT_NEAR(batched.residual(), odd.residual(), 1e-6);
+
+    auto fitted = single.fit();
+    EXPECT_NEAR(std::abs(fitted.n() * first.n()), 1, 1e-4);
+    EXPECT_NEAR(first.get_distance(fitted.get_canonical_anchor()), 0, 1e-3);
+    double residual = 0;
+    for (Eigen::Index i = 0; i < count; i += 2) {
+        double d = fitted.get_distance(PointVector(Vector(points.col(i))));
+        residual += d * d;
+    }
+    EXPECT_NEAR(single.residual(), residual, 1e-9);
+
+    LineFitter point;
+    point.add(PointVector(1, 1, 1));
+    point.add(PointVector(1, 1, 1));
+    EXPECT_THROW(point.fit(), std::domain_error); // NOLINT
+    EXPECT_THROW(LineFitter().centroid(), std::domain_error); // NOLINT
+
+    // The spread is compared as a sum of squared distances, so close but distinct points still give a line
+    LineFitter close;
+    close.add(PointVector(1, 1, 1));
+    close.add(PointVector(1, 1, 1 + 1e-5));
+    EXPECT_NEAR(std::abs(close.fit().n().get().z()), 1, 1e-9);
+
+    // The same without exceptions
+    UnitLine stored(PointVector(0, 0, 0), PointVector(1, 0, 0));
+    EXPECT_FALSE(point.fit(stored));
+    EXPECT_EQ(stored, UnitLine(PointVector(0, 0, 0), PointVector(1, 0, 0)));
+    EXPECT_TRUE(close.fit(stored));
+    EXPECT_EQ(stored, close.fit());
+
+    // A cluster of repeated measurements of one point is skipped instead of throwing
+    PointBuffer cluster(3, 50);
+    for (Eigen::Index i = 0; i < cluster.cols(); i++) {
+        cluster.col(i) << (i % 2 == 0 ? 0.6e-7 : -0.6e-7), 0, 0;
+    }
+    LineFitter measurements;
+    measurements.add(cluster);
+    EXPECT_THROW(measurements.fit(), std::domain_error); // NOLINT
+    std::vector<ExtractedLine> skipped;
+    EXPECT_NO_THROW(skipped = extract_lines(cluster, 0.01, 5)); // NOLINT
+    EXPECT_TRUE(skipped.empty());
+
+    // RANSAC finds both lines and leaves the outliers
+    auto lines = extract_lines(points, 0.05, 500);
+    ASSERT_EQ(lines.size(), 2u);
+    std::size_t found = 0;
+    for (const auto &extracted : lines) {
+        const UnitLine &expected = std::abs(extracted.line.n() * first.n()) > 0.5 ? first : second;
+        EXPECT_NEAR(std::abs(extracted.line.n() * expected.n()), 1, 1e-4);
+        EXPECT_NEAR(expected.get_distance(extracted.line.get_canonical_anchor()), 0, 1e-2);
+        EXPECT_GE(extracted.inliers.size(), static_cast<std::size_t>(count / 2));
+        found += extracted.inliers.size();
+        for (auto inlier : extracted.inliers) {
+            EXPECT_LE(extracted.line.get_distance(PointVector(Vector(points.col(inlier)))), 0.05);
+        }
+    }
+    EXPECT_LT(found, static_cast<std::size_t>(count + 50));
+}
+
+TEST(Screws, Line_Registration) { //NOLINT
+    DualFrame frame(RotationMatrix(0.4, -1.2, 2.1), PointVector(1, -2, 0.5));
+
+    std::vector<UnitLine> from;
+    std::vector<UnitLine> to;
+    for (int i = 0; i < 20; i++) {
+        from.emplace_back(PointVector(Vector(Eigen::Vector3d::Random())), PointVector(Vector(Eigen::Vector3d::Random())));
+        to.push_back(frame * from.back());
+    }
+    EXPECT_TRUE(register_lines(from, to) == frame);
+
+    // Two lines are sufficient, parallel lines are not
+    EXPECT_TRUE(register_lines({from[0], from[1]}, {to[0], to[1]}) == frame);
+    UnitLine z(PointVector(0, 0, 0), PointVector(0, 0, 1));
+    UnitLine shifted_z(PointVector(1, 0, 0), PointVector(1, 0, 1));
+    EXPECT_THROW(register_lines({z, shifted_z}, {frame * z, frame * shifted_z}), std::domain_error); // NOLINT
+    EXPECT_THROW(register_lines({z}, {}), std::invalid_argument); // NOLINT
+
+    // Wrong correspondences are suppressed by the robust weights, but not entirely ignored
+    ScrewBuffer from_buffer(6, from.size());
+    ScrewBuffer to_buffer(6, to.size());
+    for (std::size_t i = 0; i < from.size(); i++) {
+        from_buffer.col(i) << from[i].n().get(), from[i].m().get();
+        to_buffer.col(i) << to[i].n().get(), to[i].m().get();
+    }
+    to_buffer.col(3).swap(to_buffer.col(7));
+
+    auto plain = register_lines(from_buffer, to_buffer);
+    auto robust = register_lines(from_buffer, to_buffer, 0.01, 50);
+    ASSERT_TRUE(robust.valid);
+    EXPECT_FALSE(plain.frame == frame);
+    EXPECT_TRUE(robust.frame.R().get().isApprox(frame.R().get(), 1e-4));
+    EXPECT_TRUE(robust.frame.p().get().isApprox(frame.p().get(), 1e-4));
+    EXPECT_LT(robust.error, plain.error);
+
+    // Independent registrations on several threads
+    std::vector<ScrewBuffer> many_from(30, from_buffer);
+    std::vector<ScrewBuffer> many_to(30, to_buffer);
+    many_to[5].col(0).setZero();
+    auto registrations = register_lines(many_from, many_to, 0.01, 50, 4);
+    ASSERT_EQ(registrations.size(), 30u);
+    for (const auto &registration : registrations) {
+        EXPECT_TRUE(registration.valid);
+        EXPECT_TRUE(registration.frame.p().get().isApprox(frame.p().get(), 1e-4));
+    }
+    EXPECT_FALSE(register_lines(from_buffer.leftCols(1), to_buffer.leftCols(1)).valid);
+}